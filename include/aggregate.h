@@ -0,0 +1,95 @@
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include "disk_manager.h"
+#include <cstdint>
+
+// Funciones de agregación soportadas
+enum class AggregateFunction { COUNT, SUM, AVG, MIN, MAX };
+
+// Especificación de un agregado, p. ej. AVG(Fare) o COUNT(*)
+struct AggregateSpec {
+    AggregateFunction function;
+    std::string attribute;  // Vacío para COUNT(*)
+    
+    AggregateSpec(AggregateFunction func = AggregateFunction::COUNT, 
+                  const std::string& attr = "");
+    
+    // Analizar un texto como "AVG(Fare)"; devuelve false si no es válido
+    static bool parse(const std::string& text, AggregateSpec& spec);
+    std::string toString() const;
+};
+
+// Estado parcial de un agregado dentro de un grupo
+struct AggregateState {
+    long long count;
+    double sum;
+    double min;
+    double max;
+    
+    AggregateState();
+    void update(double value);
+    void merge(const AggregateState& other);
+};
+
+// Fila compacta del resultado: valores de agrupación y un valor por agregado
+struct AggregateRow {
+    std::vector<std::string> group_values;
+    std::vector<double> values;
+};
+
+// Tabla hash de direccionamiento abierto (sondeo lineal) para las claves
+// de grupo, con el hash de hashValue. Los estados de todos los grupos se guardan contiguos en un
+// único vector para recorrerlos sin saltos de puntero.
+class GroupHashTable {
+private:
+    struct Slot {
+        uint64_t hash;
+        int group;  // -1 si el slot está vacío
+    };
+    
+    std::vector<Slot> slots;
+    std::vector<std::string> keys;
+    std::vector<AggregateState> states;  // keys.size() * states_per_group
+    int states_per_group;
+    
+    void grow();
+    
+public:
+    explicit GroupHashTable(int num_states);
+    
+    // Estados del grupo 'key' (se crea si no existe)
+    AggregateState* findOrInsert(const std::string& key, uint64_t hash);
+    void merge(const GroupHashTable& other);
+    
+    int getGroupCount() const;
+    const std::string& getKey(int group) const;
+    const AggregateState* getStates(int group) const;
+};
+
+// Operador de agregación hash con GROUP BY que se ejecuta dentro del recorrido.
+// Cada hilo agrega un subconjunto de bloques en su propia tabla y al final
+// se combinan las tablas parciales. Cada hilo fija solo el bloque que está
+// agregando, así que el buffer nunca tiene más de un bloque fijado por hilo.
+class AggregationOperator {
+private:
+    std::vector<std::string> group_by;
+    std::vector<AggregateSpec> specs;
+    Predicate predicate;
+    
+    void consumeBlock(const Block* block, GroupHashTable& table, std::string& key) const;
+    
+public:
+    AggregationOperator(const std::vector<std::string>& group_attributes,
+                        const std::vector<AggregateSpec>& aggregate_specs,
+                        const Predicate& filter = Predicate());
+    
+    // Los bloques se cargan y fijan a través de 'buffer'; devuelve false si
+    // alguno no se pudo cargar
+    bool execute(const std::vector<Block*>& blocks, BufferManager& buffer,
+                 std::vector<AggregateRow>& rows, int max_threads = 0) const;
+    
+    void printResult(const std::vector<AggregateRow>& rows, std::ostream& out = std::cout) const;
+};
+
+#endif // AGGREGATE_H
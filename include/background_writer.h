@@ -0,0 +1,80 @@
+#ifndef BACKGROUND_WRITER_H
+#define BACKGROUND_WRITER_H
+
+#include "disk_manager.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Configuración del escritor en segundo plano
+struct WriterConfig {
+    size_t io_bytes_per_second;   // Presupuesto de escritura (0 = sin límite)
+    int interval_ms;              // Periodo entre rondas
+    int lru_scan_depth;           // Bloques del final de la LRU que se mantienen limpios
+    int checkpoint_interval_ms;   // Periodo entre checkpoints difusos (0 = ninguno)
+    double wakeup_fill;           // Ocupación del buffer a partir de la cual una víctima
+                                  // sucia adelanta la ronda (fracción del presupuesto)
+
+    WriterConfig(size_t bytes_per_second = 4 * 1024 * 1024, int interval = 50,
+                 int scan_depth = 16, int checkpoint_interval = 1000,
+                 double wakeup = 0.9);
+};
+
+// Hilo que vuelca bloques sucios sin que lo haga la operación en primer plano.
+// En cada ronda completa primero el checkpoint en curso y después limpia el
+// final de la LRU, hasta gastar el presupuesto de bytes de la ronda. Toma el
+// latch del SGBD para cada bloque por separado, de modo que las operaciones
+// en primer plano solo esperan, como mucho, la escritura de un bloque.
+// El buffer manager lo despierta antes de su periodo cuando la siguiente
+// víctima está sucia, y la parte de la LRU que limpia crece con la memoria
+// desalojada desde la ronda anterior.
+class BackgroundWriter {
+private:
+    BufferManager& buffer;
+    std::recursive_mutex& latch;   // Latch del SGBD que protege bloques y disco
+    WriterConfig config;
+
+    std::thread worker;
+    std::mutex control_mutex;
+    std::condition_variable control;
+    std::condition_variable round_done;
+    bool running;
+    bool checkpoint_requested;
+    bool in_round;                 // Hay una ronda en curso (con 'control_mutex' libre)
+    long long rounds_completed;
+    long long io_credit;  // Bytes que aún puede escribir el hilo (negativo: en deuda)
+    std::atomic<bool> wakeup_pending;
+    std::chrono::steady_clock::time_point last_round;
+    long long last_evicted_bytes;  // Desalojos vistos en la ronda anterior
+    size_t eviction_window;        // Bytes de la LRU a mantener limpios
+
+    std::atomic<long long> rounds;
+    std::atomic<long long> blocks_written;
+    std::atomic<long long> bytes_written;
+
+    void run();
+    void doRound(bool begin_checkpoint);
+
+public:
+    BackgroundWriter(BufferManager& buffer_manager, std::recursive_mutex& engine_latch);
+    ~BackgroundWriter();
+
+    bool start(const WriterConfig& writer_config);
+    void stop();
+    bool isRunning();
+
+    // Adelantar el siguiente checkpoint a la próxima ronda
+    void requestCheckpoint();
+    // Adelantar la próxima ronda; lo llama el buffer manager con el latch tomado
+    void wakeup();
+    // Despertar al hilo y esperar a que termine una ronda empezada después
+    // de la llamada (false si no está en marcha). No debe llamarse con el
+    // latch tomado: la ronda lo necesita para escribir.
+    bool runRound();
+
+    void printStats();
+};
+
+#endif // BACKGROUND_WRITER_H
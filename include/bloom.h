@@ -0,0 +1,43 @@
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include "query.h"
+#include "snapshot.h"
+
+// Filtro de Bloom bloqueado: cada clave activa sus k bits dentro de una única
+// línea de caché de 64 bytes, por lo que una consulta toca una sola línea.
+class BloomFilter {
+private:
+    static const int WORDS_PER_LINE = 8;   // 8 x 64 bits = 512 bits = 64 bytes
+    static const int BITS_PER_LINE = 512;
+    
+    std::vector<uint64_t> words;
+    int num_lines;
+    int num_hashes;
+    int expected_keys;
+    int inserted_keys;
+    double target_fpr;
+    
+    void addHash(uint64_t hash);
+    bool mayContainHash(uint64_t hash) const;
+    
+public:
+    BloomFilter(int expected = 64, double fpr = 0.01);
+    
+    // Los valores numéricos se normalizan para que "7.25" y "7.250" coincidan,
+    // igual que en Comparison
+    void add(const std::string& value);
+    bool mayContain(const Comparison& comparison) const;
+    
+    void clear();
+    bool isOverloaded() const;   // Más claves de las previstas en el diseño
+    int getExpectedKeys() const;
+    double getTargetFpr() const;
+    double estimateFpr() const;  // A partir de la fracción de bits activos
+    size_t getMemoryBytes() const;
+    
+    void save(SnapshotWriter& out) const;
+    bool load(SnapshotReader& in);
+};
+
+#endif // BLOOM_H
@@ -0,0 +1,70 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include "sgbd_basic.h"
+#include "statistics.h"
+
+// Estadísticas básicas de una tabla, mantenidas en cada inserción y borrado
+struct TableStats {
+    int row_count;          // Registros activos
+    int deleted_count;      // Registros marcados como eliminados
+    long long data_bytes;   // Bytes codificados de los registros activos
+    
+    TableStats();
+};
+
+// Tabla: esquema y heap de bloques propio
+class Table {
+public:
+    std::string name;
+    std::vector<std::string> schema;  // Columnas en el orden de creación
+    std::vector<int> block_ids;       // Heap de bloques de la tabla
+    int insert_block_id;              // Último bloque usado para insertar (-1 si ninguno)
+    TableStats stats;
+    std::map<std::string, double> bloom_columns;  // Columnas con filtro de Bloom -> FPR objetivo
+    std::map<std::string, ColumnStats> column_stats;  // Estadísticas aproximadas por columna
+    bool analyzed;                    // Se ha ejecutado ANALYZE (histogramas disponibles)
+    
+    Table(const std::string& table_name = "", 
+          const std::vector<std::string>& columns = std::vector<std::string>());
+    
+    bool hasColumn(const std::string& column) const;
+    // Añadir al esquema las columnas nuevas que aparezcan en un registro
+    void extendSchema(const Record& record);
+    
+    // Mantener incrementalmente las estadísticas de columna
+    void addToColumnStats(const Record& record);
+    void removeFromColumnStats(const Record& record);
+    
+    // Fracción estimada de registros activos que cumplen el predicado
+    double estimateSelectivity(const Predicate& predicate) const;
+    void printColumnStats() const;
+    
+    // Memoria del esquema, el heap de bloques y las estadísticas
+    size_t getMemoryUsage() const;
+    void print() const;
+    
+    void save(SnapshotWriter& out) const;
+    bool load(SnapshotReader& in);
+};
+
+// Catálogo de tablas con nombre
+class Catalog {
+private:
+    std::map<std::string, Table> tables;
+    
+public:
+    Table* createTable(const std::string& name, const std::vector<std::string>& schema);
+    Table* getTable(const std::string& name);
+    const Table* getTable(const std::string& name) const;
+    bool hasTable(const std::string& name) const;
+    std::vector<std::string> getTableNames() const;
+    int getTableCount() const;
+    void print() const;
+    
+    void save(SnapshotWriter& out) const;
+    // Sustituye todas las tablas por las de la instantánea
+    bool load(SnapshotReader& in);
+};
+
+#endif // CATALOG_H
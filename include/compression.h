@@ -0,0 +1,105 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include "sgbd_basic.h"
+#include <cstdint>
+#include <string_view>
+
+// Compresor de bytes genérico y rápido (estilo LZ4): secuencias de literales
+// seguidas de coincidencias (offset de 16 bits, longitud mínima 4)
+class LZCodec {
+public:
+    static std::string compress(const std::string& input);
+    // Devuelve false si los datos están corruptos o no producen 'original_size' bytes
+    static bool decompress(std::string_view input, size_t original_size, std::string& output);
+};
+
+// Codificación de columnas dentro de un bloque
+enum class ColumnEncoding : uint8_t {
+    PLAIN = 0,       // Longitud + bytes
+    DICTIONARY = 1,  // Diccionario por bloque + código de 1 byte (baja cardinalidad)
+    FRAME_OF_REFERENCE = 2  // Enteros como diferencia respecto al mínimo del bloque
+};
+
+// Formato de bloque comprimido.
+// Cabecera: 'B' 'K', versión, flags (bit 0: cuerpo comprimido con LZCodec).
+// Cuerpo columnar: número de registros, IDs en delta, bitmap de borrados y,
+// por cada columna, nombre, bitmap de presencia, codificación y valores.
+class BlockCodec {
+public:
+    static const uint8_t FORMAT_VERSION = 1;
+    static const uint8_t FLAG_LZ = 0x01;
+    
+    static std::string encode(const std::vector<Record>& records);
+    // Acepta también el formato de texto heredado (un registro serializado por línea)
+    static bool decode(const std::string& data, std::vector<Record>& records);
+    static bool isEncoded(std::string_view data);
+};
+
+// Lectura de un bloque en el formato de BlockCodec sin decodificarlo: open()
+// solo analiza la cabecera y dónde empieza cada columna, y los valores se
+// leen de los bytes codificados cuando se piden. La posición de cada valor
+// se calcula la primera vez que se accede a su columna, así que las
+// columnas que nadie consulta no se recorren dos veces. Los buffers se
+// conservan entre bloques: recorrer muchos bloques con el mismo objeto no
+// reserva memoria por fila.
+class EncodedBlock {
+public:
+    static const size_t INTEGER_TEXT_BYTES = 24;
+    
+    EncodedBlock();
+    
+    // Analizar 'data', que debe seguir vivo mientras se use el bloque.
+    // false si no está en el formato columnar (texto heredado) o está corrupto
+    bool open(std::string_view data);
+    
+    size_t getRowCount() const;
+    int getRecordId(size_t row) const;
+    bool isDeleted(size_t row) const;
+    // Fila de un ID de registro (-1 si no está en el bloque)
+    long findRow(int record_id) const;
+    
+    size_t getColumnCount() const;
+    std::string_view getColumnName(size_t column) const;
+    // Columna por nombre (-1 si el bloque no la tiene)
+    int findColumn(const std::string& name) const;
+    
+    // Valor de una fila en una columna; false si la fila no lo tiene. Los
+    // textos apuntan a los bytes del bloque; los enteros de frame of
+    // reference se escriben en un buffer de la columna y son válidos hasta
+    // leer la misma columna en otra fila.
+    bool getValue(size_t column, size_t row, std::string_view& value) const;
+    
+    // Columnas cuyos valores se llegaron a localizar desde el último open()
+    size_t getColumnsAccessed() const;
+    
+private:
+    static constexpr uint32_t NO_VALUE = 0xFFFFFFFF;
+    
+    struct Column {
+        std::string_view name;
+        size_t bitmap_offset;
+        ColumnEncoding encoding;
+        int64_t base;                          // FRAME_OF_REFERENCE
+        std::vector<std::string_view> dictionary;
+        size_t values_offset;                  // Primer valor de la columna
+        bool located;                          // 'offsets' ya calculado
+        std::vector<uint32_t> offsets;         // Posición del valor de cada fila
+        char integer_text[INTEGER_TEXT_BYTES];
+    };
+    
+    std::string_view body;
+    std::string decompressed;
+    size_t row_count;
+    size_t deleted_offset;
+    std::vector<int> record_ids;
+    size_t column_count;
+    mutable std::vector<Column> columns;   // Solo las primeras 'column_count' son del bloque actual
+    
+    // Recorrer los valores de una columna desde 'pos' (registrando su
+    // posición si se pide); false si los bytes no son válidos
+    bool walkValues(const Column& column, size_t& pos, std::vector<uint32_t>* offsets) const;
+    bool locate(Column& column) const;
+};
+
+#endif // COMPRESSION_H
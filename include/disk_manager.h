@@ -2,48 +2,211 @@
 #define DISK_MANAGER_H
 
 #include "sgbd_basic.h"
+#include "query.h"
+#include "compression.h"
+#include "zone_map.h"
+#include "bloom.h"
 #include <unordered_map>
-#include <queue>
+#include <unordered_set>
+#include <list>
+#include <algorithm>
+#include <functional>
+
+class DiskManager;
 
 // Clase para representar un bloque de datos
 class Block {
 public:
     int block_id;
+    std::string table_name;          // Tabla a cuyo heap pertenece el bloque
     std::vector<Record> records;
-    int max_records;
-    PhysicalLocation location;
+    int capacity_bytes;              // Tamaño de la página del bloque
+    int used_bytes;                  // Bytes ocupados por los registros codificados
+    double fill_factor;              // Fracción de la página usable al insertar
+    PhysicalLocation location;       // Primer sector del bloque
+    std::vector<Extent> extents;     // Extent map: sectores que ocupa el bloque
+    ZoneMap zone_map;                // Min/max y nulos por columna de los registros activos
+    std::map<std::string, BloomFilter> bloom_filters;  // Filtros de Bloom por columna configurada
     bool is_dirty;  // Indica si el bloque ha sido modificado
+    bool is_loaded;                  // Los registros están en memoria (si no, solo metadatos)
+    int pin_count;                   // Usuarios activos: el buffer no puede descargarlo
+    size_t record_heap_bytes;        // Memoria de heap de los registros cargados
+    size_t stored_bytes;             // Tamaño comprimido de la última escritura en disco
     
-    Block(int id, int max_rec);
-    bool hasSpace() const;
+    Block(int id, int capacity, double fill = 1.0);
+    // Bytes que quedan libres antes de alcanzar el fill factor
+    int getFreeSpace() const;
+    bool hasSpace(int required_bytes) const;
+    static int encodedSize(const Record& record);
     bool addRecord(const Record& record);
     bool removeRecord(int record_id);
+    // Sustituir un registro activo por su nueva versión si sigue cabiendo en
+    // la página completa (el margen del fill factor queda para las actualizaciones)
+    bool updateRecord(const Record& updated);
+    // Sacar físicamente un registro del bloque para reubicarlo en otro
+    bool extractRecord(int record_id);
     Record* findRecord(int record_id);
     std::vector<Record*> findRecordsByAttribute(const std::string& attribute, 
                                                const std::string& value, 
                                                const std::string& operator_type);
+    // Evaluar un predicado compilado sobre todos los registros del bloque
+    std::vector<Record*> findRecords(const Predicate& predicate);
+    // Consultar el zone map: false si ningún registro puede cumplir el predicado
+    bool mayMatch(const Predicate& predicate) const;
+    
+    // Crear (o reconstruir) el filtro de Bloom de una columna con los registros actuales
+    void enableBloomFilter(const std::string& column, double fpr);
+    // Consultar los filtros de Bloom en las igualdades del predicado.
+    // 'consulted' indica si algún filtro llegó a intervenir.
+    bool bloomMayMatch(const Predicate& predicate, bool& consulted) const;
+    
+    // Serializar / deserializar el contenido completo del bloque
+    // (formato columnar comprimido de BlockCodec)
+    std::string serialize() const;
+    bool deserialize(const std::string& block_data);
+    
     void print() const;
+    
+    // Liberar los registros conservando zone map, filtros y extent map.
+    // Solo debe hacerse con el bloque limpio y sin pins.
+    void unload();
+    // Memoria de los registros cargados (lo que descarga el buffer)
+    size_t getMemoryUsage() const;
+    // Memoria de los metadatos que permanecen siempre en memoria
+    size_t getMetadataMemory() const;
+    
+    // Metadatos que se conservan al descargar el bloque (extent map, zone
+    // map, filtros de Bloom, ocupación). Un bloque restaurado queda
+    // descargado: sus registros se leen de disco al usarlo. Se rechazan
+    // los extents que no caben en la geometría de 'disk'.
+    void saveMetadata(SnapshotWriter& out) const;
+    bool loadMetadata(SnapshotReader& in, const DiskManager& disk);
+    
+private:
+    bool bloomMayMatchNode(const Predicate::Node& node, bool& consulted) const;
+    void rebuildBloomFilters();
 };
 
-// Buffer Manager - Gestiona bloques en memoria
+// Buffer Manager - Gestiona los bloques cargados en memoria con un
+// presupuesto en bytes. Los bloques pertenecen al SGBD: al desalojar uno se
+// escribe si está sucio y se descargan sus registros, pero el bloque sigue
+// existiendo con sus metadatos y se recarga desde disco al volver a usarlo.
 class BufferManager {
 private:
-    std::unordered_map<int, Block*> buffer_pool;
-    std::queue<int> lru_queue;  // Para política LRU simple
-    int max_buffer_size;
+    struct Frame {
+        Block* block;
+        size_t charged_bytes;                 // Memoria contabilizada del bloque
+        std::list<int>::iterator lru_position;
+    };
+    
+    std::unordered_map<int, Frame> buffer_pool;
+    std::list<int> lru_list;    // Frente: bloque usado más recientemente
+    size_t max_buffer_bytes;
+    size_t used_bytes;
+    DiskManager* disk_manager;  // Destino de las escrituras y origen de las cargas
+    std::ostream* output;       // Mensajes de cada escritura (std::cout por defecto)
+    
+    long long hits;
+    long long loads;
+    long long evictions;
+    long long evicted_bytes;       // Memoria liberada por los desalojos
+    long long dirty_evictions;     // Desalojos que tuvieron que escribir la víctima
+    long long background_writes;   // Bloques escritos por el escritor en segundo plano
+    
+    // Checkpoint difuso en curso: bloques sucios al empezar que aún no se
+    // han escrito. Cualquier escritura posterior (desalojo incluido) cuenta.
+    std::unordered_set<int> checkpoint_pending;
+    bool checkpoint_active;
+    Timer checkpoint_timer;
+    int checkpoint_blocks;         // Bloques sucios al empezar el checkpoint en curso
+    long long checkpoints_completed;
+    double last_checkpoint_ms;
+    int last_checkpoint_blocks;
+    
+    // Aviso al escritor en segundo plano cuando se queda atrás: un desalojo
+    // tuvo que escribir la víctima, o la siguiente víctima está sucia con el
+    // buffer por encima de 'wakeup_bytes'
+    std::function<void()> writer_wakeup;
+    size_t wakeup_bytes;
+    
+    void touch(Frame& frame);
+    // Desalojar bloques sin pins hasta quedar dentro del presupuesto,
+    // sin tocar 'keep' (el bloque que se está usando)
+    void enforceBudget(const Block* keep);
+    bool evictBlock(int block_id);
+    void finishCheckpoint();
     
 public:
-    BufferManager(int max_size);
+    BufferManager(size_t max_bytes);
     ~BufferManager();
     
+    void attachDisk(DiskManager* disk);
+    void setOutput(std::ostream& stream);
     Block* getBlock(int block_id);
+    // Registrar un bloque recién creado (ya residente)
     bool addBlock(Block* block);
+    // Asegurar que el bloque está cargado, recargándolo desde disco si hace falta
+    Block* fetchBlock(Block* block);
+    // Igual que fetchBlock, pero impide su desalojo hasta unpinBlock
+    Block* pinBlock(Block* block);
+    // Al soltar el último pin se vuelve a aplicar el presupuesto, así que
+    // el bloque puede desalojarse en ese momento
+    void unpinBlock(Block* block);
+    // Recontabilizar la memoria de un bloque tras modificarlo
+    void updateUsage(Block* block);
     void evictLRU();
     void flushAllBlocks();
-    void writeBlockToDisk(Block* block);
+    void clear();
+    // 'log' = false para las escrituras en segundo plano, que no deben
+    // mezclar mensajes con los de la operación en primer plano
+    void writeBlockToDisk(Block* block, bool log = true);
+    
+    // Trabajo del escritor en segundo plano: cada llamada escribe como mucho
+    // un bloque y devuelve los bytes escritos (0 si no había nada que hacer)
+    size_t writeCheckpointBlock();
+    // Limpiar el primer bloque sucio entre los 'scan_depth' últimos de la
+    // LRU, ampliando la ventana hasta cubrir 'scan_bytes' de memoria
+    size_t cleanLRUTail(int scan_depth, size_t scan_bytes = 0);
+    // Registrar (o quitar, con nullptr) el aviso al escritor en segundo plano
+    void setWriterWakeup(std::function<void()> wakeup, size_t fill_bytes);
+    // Empezar un checkpoint difuso con los bloques sucios actuales, sin
+    // detener las operaciones en curso
+    void beginCheckpoint();
+    bool isCheckpointActive() const;
+    
+    // Bloques sucios residentes y su memoria: lo que se perdería sin
+    // volcar, y por tanto la cota del trabajo de recuperación
+    int getDirtyCount() const;
+    size_t getDirtyBytes() const;
+    
+    long long getEvictions() const;
+    long long getEvictedBytes() const;
+    long long getDirtyEvictions() const;
+    
+    size_t getMaxBytes() const;
+    size_t getUsedBytes() const;
+    size_t getMetadataMemory() const;
+    int getResidentCount() const;
     void printBufferStatus();
 };
 
+// Pin de un bloque mientras vive el objeto: se suelta al salir del ámbito,
+// también si el código que usa los registros lanza una excepción
+class BlockPin {
+private:
+    BufferManager& buffer;
+    Block* block;  // nullptr si no se pudo cargar o ya se soltó
+    
+public:
+    BlockPin(BufferManager& buffer_manager, Block* target);
+    ~BlockPin();
+    BlockPin(const BlockPin&) = delete;
+    BlockPin& operator=(const BlockPin&) = delete;
+    
+    Block* get() const;
+    void release();
+};
+
 // Disk Manager - Gestiona la estructura física del disco
 class DiskManager {
 private:
@@ -53,31 +216,104 @@ private:
     int tracks_per_surface;
     int sectors_per_track;
     int sector_capacity;
-    int records_per_block;
+    int block_size;  // Tamaño de página en bytes, independiente del sector
     
     int next_record_id;
     int next_block_id;
+    long long stored_block_bytes;  // Suma de stored_bytes de los bloques escritos
     
     std::unordered_map<int, PhysicalLocation> record_locations;
     BufferManager buffer_manager;
+    std::ostream* output;  // Mensajes y errores de cada operación (std::cout por defecto)
     
 public:
     DiskManager(int num_platters, int surfaces, int tracks, int sectors, 
-                int sec_capacity, int rec_per_block, int buffer_size);
+                int sec_capacity, size_t buffer_bytes, int blk_size = 0);
     
     // Calcular capacidades del disco
     long long getTotalCapacity() const;
     long long getUsedCapacity() const;
     long long getFreeCapacity() const;
     
-    // Encontrar ubicación para almacenar un bloque
-    PhysicalLocation findLocationForBlock(int required_space);
+    // Memoria real del disco simulado: metadatos de la geometría y el
+    // contenido de los sectores escritos (no la capacidad configurada)
+    size_t getMemoryUsage() const;
+    int getMaterializedTracks() const;
+    
+    // Reservar / liberar extensiones de sectores contiguos
+    std::vector<Extent> allocateExtents(int num_sectors);
+    void freeExtents(const std::vector<Extent>& extents);
+    int getExtentCapacity(const std::vector<Extent>& extents) const;
+    // Comprobar que un extent cae dentro de la geometría del disco
+    bool isValidExtent(const Extent& extent) const;
     
-    // Almacenar un bloque en el disco
+    // Leer / escribir bytes repartidos sobre una lista de extensiones
+    bool writeExtents(const std::vector<Extent>& extents, const std::string& content);
+    std::string readExtents(const std::vector<Extent>& extents) const;
+    // Igual, reutilizando la memoria de 'content' entre lecturas
+    void readExtents(const std::vector<Extent>& extents, std::string& content) const;
+    
+    // Almacenar un bloque en el disco (reserva su extent map y lo escribe)
     bool storeBlock(Block* block);
     
+    // Reescribir un bloque ya almacenado, ampliando sus extensiones si crece
+    bool writeBlock(Block* block);
+    
+    // Cargar el contenido de un bloque desde sus extensiones
+    bool loadBlock(Block* block);
+    
+    // Bytes comprimidos de los bloques en disco según su última escritura
+    long long getStoredBlockBytes() const;
+    // Contabilizar bloques que llegan ya escritos (restaurados de una instantánea)
+    void addStoredBlockBytes(long long bytes);
+    
+    int getBlockSize() const;
+    int getSectorCapacity() const;
+    size_t getBufferCapacity() const;
+    
+    // Geometría y contenido de los sectores reservados o escritos, pista a
+    // pista (solo las materializadas). Cargarlos exige un disco sin usar con
+    // la misma geometría.
+    void saveSectors(SnapshotWriter& out) const;
+    bool loadSectors(SnapshotReader& in, std::string& error);
+    // Liberar todos los sectores (deshacer una restauración fallida)
+    void clearSectors();
+    
     void printDiskStatus();
     BufferManager& getBufferManager();
+    
+    // Destino de los mensajes por operación (también los del buffer); los
+    // informes print* siguen yendo a std::cout
+    void setOutput(std::ostream& stream);
+    std::ostream& getOutput();
+};
+
+// Fichero temporal sobre el disco simulado para los operadores que no caben
+// en memoria (particiones de hash join, runs de ordenación externa).
+// Los datos se acumulan en una página y se escriben página a página en
+// extensiones nuevas; al destruirse se liberan todos sus sectores.
+class SpillFile {
+private:
+    DiskManager* disk;
+    int page_size;
+    std::vector<std::vector<Extent>> pages;
+    std::string buffer;
+    long long total_bytes;
+    
+public:
+    explicit SpillFile(DiskManager* disk_manager);
+    ~SpillFile();
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+    
+    bool append(const std::string& data);
+    bool flush();
+    
+    int getPageCount() const;
+    long long getSize() const;
+    bool readPage(int index, std::string& page) const;
+    std::string readAll() const;
+    void release();
 };
 
 #endif // DISK_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,91 @@
+#ifndef INDEX_H
+#define INDEX_H
+
+#include "sgbd_basic.h"
+#include "snapshot.h"
+#include <memory>
+#include <unordered_map>
+
+// Índice secundario hash sobre un atributo: valor -> IDs de registro.
+// Las claves se guardan en forma canónica (canonicalValue) para que una
+// búsqueda por "7.0" encuentre los registros con "7", como un recorrido.
+class HashIndex {
+private:
+    std::string attribute;
+    std::unordered_map<std::string, std::vector<int>> entries;
+    int total_entries;
+    
+public:
+    HashIndex(const std::string& attr = "");
+    
+    const std::string& getAttribute() const;
+    void insert(const std::string& value, int record_id);
+    bool remove(const std::string& value, int record_id);
+    
+    // IDs de los registros cuyo atributo es exactamente 'value'
+    const std::vector<int>* lookup(const std::string& value) const;
+    
+    int getEntryCount() const;
+    int getDistinctValues() const;
+    size_t getMemoryUsage() const;
+    void print() const;
+    
+    void save(SnapshotWriter& out) const;
+    bool load(SnapshotReader& in);
+};
+
+// Índice de prefijos sobre un atributo de texto: árbol radix (trie con
+// caminos comprimidos) de valor -> IDs de registro. Cada nodo cuenta los
+// IDs de su subárbol, así que contar los registros con un prefijo cuesta
+// lo que mide el prefijo, y listarlos, además, lo que ocupa el resultado,
+// sin depender del tamaño de la tabla.
+class PrefixIndex {
+private:
+    static const int MAX_LOAD_DEPTH = 4096;
+    
+    struct Node {
+        std::string label;             // Fragmento del valor en la arista que llega al nodo
+        std::vector<int> record_ids;   // Registros cuyo valor termina en este nodo
+        std::vector<std::unique_ptr<Node>> children;  // Ordenados por el primer byte
+        int subtree_count;             // IDs en el nodo y sus descendientes
+        
+        Node();
+    };
+    
+    std::string attribute;
+    std::unique_ptr<Node> root;
+    int distinct_values;
+    int node_count;
+    
+    // Hijo cuya etiqueta empieza por 'first' (o la posición donde insertarlo)
+    static size_t childPosition(const Node& node, unsigned char first);
+    // Nodo bajo el que están todos los valores con el prefijo (nullptr si ninguno)
+    const Node* findPrefix(const std::string& prefix) const;
+    static void collect(const Node& node, std::vector<int>& record_ids);
+    size_t nodeMemory(const Node& node) const;
+    static void saveNode(const Node& node, SnapshotWriter& out);
+    bool loadNode(Node& node, SnapshotReader& in, int depth);
+    
+public:
+    PrefixIndex(const std::string& attr = "");
+    
+    const std::string& getAttribute() const;
+    void insert(const std::string& value, int record_id);
+    bool remove(const std::string& value, int record_id);
+    
+    // Registros cuyo atributo empieza por 'prefix' (en orden de valor)
+    int countPrefix(const std::string& prefix) const;
+    std::vector<int> lookupPrefix(const std::string& prefix) const;
+    
+    int getEntryCount() const;
+    int getDistinctValues() const;
+    size_t getMemoryUsage() const;
+    void print() const;
+    
+    // La estructura del árbol se guarda tal cual: cargarlo no vuelve a
+    // insertar los valores
+    void save(SnapshotWriter& out) const;
+    bool load(SnapshotReader& in);
+};
+
+#endif // INDEX_H
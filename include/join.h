@@ -0,0 +1,62 @@
+#ifndef JOIN_H
+#define JOIN_H
+
+#include "disk_manager.h"
+#include <cstdint>
+
+// Fila del resultado de un join: copias de los registros de cada lado
+// (los bloques se sueltan en cuanto se recorren)
+struct JoinedRow {
+    Record left;
+    Record right;
+};
+
+// Hash join por igualdad entre dos conjuntos de bloques. Las claves se
+// comparan en forma canónica (canonicalValue), igual que en el WHERE.
+// Si el lado de construcción cabe en el presupuesto de memoria se hace un
+// hash join clásico; si no, se usa la variante grace: ambos lados se
+// particionan por hash de la clave en ficheros temporales del disco y
+// después se une partición a partición. Cada bloque se fija solo mientras se
+// recorre: la tabla hash guarda copias del lado de construcción y las
+// particiones guardan los registros serializados.
+class HashJoinOperator {
+private:
+    DiskManager* disk;
+    std::string left_key;
+    std::string right_key;
+    long long memory_budget;  // Bytes disponibles para la tabla hash
+    int partitions_used;      // 0 si el join se resolvió en memoria
+    
+    static long long estimateBytes(const std::vector<Block*>& blocks);
+    
+    // Si la tabla hash supera el presupuesto se detiene con 'over_budget' y
+    // deja en 'memory_bytes' la memoria estimada del lado de construcción
+    bool inMemoryJoin(const std::vector<Block*>& build, const std::string& build_key,
+                      const std::vector<Block*>& probe, const std::string& probe_key,
+                      bool build_is_left, std::vector<JoinedRow>& results,
+                      bool& over_budget, long long& memory_bytes);
+    
+    bool graceJoin(const std::vector<Block*>& build, const std::string& build_key,
+                   const std::vector<Block*>& probe, const std::string& probe_key,
+                   bool build_is_left, int num_partitions, std::vector<JoinedRow>& results);
+    
+    bool partition(const std::vector<Block*>& blocks, const std::string& key,
+                   std::vector<SpillFile*>& partitions);
+    
+    // Recorrer los registros activos de los bloques fijando uno cada vez
+    // (false si algún bloque no se pudo cargar)
+    bool forEachRecord(const std::vector<Block*>& blocks,
+                       const std::function<bool(const Record&)>& consumer);
+    
+public:
+    HashJoinOperator(DiskManager* disk_manager, const std::string& left_attribute,
+                     const std::string& right_attribute, long long budget_bytes);
+    
+    // Devuelve false si algún bloque no se pudo cargar o falló el disco
+    bool execute(const std::vector<Block*>& left_blocks,
+                 const std::vector<Block*>& right_blocks, std::vector<JoinedRow>& results);
+    
+    int getPartitionCount() const;
+};
+
+#endif // JOIN_H
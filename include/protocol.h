@@ -0,0 +1,119 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "sgbd_basic.h"
+#include <cstdint>
+
+// Protocolo binario entre sgbd_server y sus clientes.
+//
+// Cada mensaje va en una trama: longitud del contenido (uint32) seguida del
+// contenido. Los enteros son little-endian y las cadenas se codifican como
+// longitud (uint32) + bytes. Un cliente puede enviar muchas tramas seguidas
+// sin esperar respuesta (pipelining); el servidor responde a las peticiones
+// de cada conexión en el mismo orden, repitiendo su request_id.
+namespace protocol {
+
+// Tamaño máximo del contenido de una trama. Una respuesta a QUERY que no
+// cabe lleva solo las primeras filas que caben; 'count' sigue siendo el
+// total de filas encontradas.
+const uint32_t MAX_FRAME_BYTES = 16 * 1024 * 1024;
+
+enum class Opcode : uint8_t {
+    PING = 0,
+    INSERT = 1,   // table, fields, record_id (0 = lo asigna el servidor)
+    QUERY = 2,    // table, text (expresión WHERE), limit (0 = sin límite)
+    GET = 3,      // record_id
+    DELETE = 4,   // record_id
+    UPDATE = 5    // table, text (expresión WHERE), fields (asignaciones)
+};
+
+enum class Status : uint8_t {
+    OK = 0,
+    NOT_FOUND = 1,
+    ERROR = 2
+};
+
+struct Request {
+    uint32_t request_id;
+    Opcode opcode;
+    std::string table;
+    std::string text;
+    uint32_t record_id;
+    uint32_t limit;
+    std::map<std::string, std::string> fields;
+
+    Request();
+};
+
+struct Response {
+    uint32_t request_id;
+    Status status;
+    uint32_t count;       // Filas afectadas o encontradas
+    uint32_t record_id;   // ID asignado por INSERT
+    std::string message;  // Descripción del error
+    std::vector<Record> records;
+
+    Response();
+};
+
+// Escritura de los campos de una trama al final de 'out'
+class Writer {
+private:
+    std::string& out;
+    size_t frame_start;
+
+public:
+    explicit Writer(std::string& buffer);
+
+    // Reservar la cabecera de longitud de una trama nueva / rellenarla
+    void beginFrame();
+    void endFrame();
+
+    void putU8(uint8_t value);
+    void putU32(uint32_t value);
+    void putString(const std::string& value);
+    void putFields(const std::map<std::string, std::string>& fields);
+    void putRecord(const Record& record);
+
+    // Bytes que ocupa un registro escrito con putRecord
+    static size_t recordSize(const Record& record);
+};
+
+// Lectura del contenido de una trama; cada get devuelve false si se acaba
+class Reader {
+private:
+    const char* data;
+    size_t size;
+    size_t pos;
+
+public:
+    Reader(const char* payload, size_t length);
+
+    bool getU8(uint8_t& value);
+    bool getU32(uint32_t& value);
+    bool getString(std::string& value);
+    bool getFields(std::map<std::string, std::string>& fields);
+    bool getRecord(Record& record);
+    bool atEnd() const;
+};
+
+// Buscar la siguiente trama completa en 'buffer' a partir de 'offset'.
+// Devuelve 1 y avanza 'offset' si hay una, 0 si faltan bytes y -1 si la
+// longitud declarada supera MAX_FRAME_BYTES.
+int nextFrame(const std::string& buffer, size_t& offset,
+              const char*& payload, uint32_t& length);
+
+void encodeRequest(const Request& request, std::string& out);
+bool decodeRequest(const char* payload, uint32_t length, Request& request, std::string& error);
+
+// Codificar una respuesta; 'records' se pasa aparte para no copiar los
+// registros del buffer pool
+void encodeResponse(const Response& response, const std::vector<const Record*>& records,
+                    std::string& out);
+bool decodeResponse(const char* payload, uint32_t length, Response& response);
+
+const char* opcodeToString(Opcode opcode);
+
+} // namespace protocol
+
+#endif // PROTOCOL_H
@@ -0,0 +1,120 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include "sgbd_basic.h"
+#include <functional>
+#include <memory>
+#include <set>
+#include <cstdint>
+#include <string_view>
+
+class RecordView;
+
+// Operadores de comparación soportados por el motor de consultas.
+// PREFIX es LIKE 'abc%': compara como texto y la comparación guarda solo el prefijo.
+enum class CompareOp { EQ, NE, LT, LE, GT, GE, PREFIX };
+
+// Convertir el texto de un operador ("=", "!=", "<>", "<", "<=", ">", ">=", "LIKE")
+bool parseCompareOp(const std::string& text, CompareOp& op);
+std::string compareOpToString(CompareOp op);
+
+// Extraer el prefijo de un patrón LIKE. Solo se admite un '%' final
+// ('abc%'); el resto de caracteres, '_' incluido, son literales.
+bool parseLikePattern(const std::string& pattern, std::string& prefix);
+
+// Comparar dos valores: numéricamente si ambos son números, si no lexicográficamente
+int compareValues(const std::string& a, const std::string& b);
+
+// Orden total para ordenar valores (std::sort, histogramas): números (por
+// valor) antes que textos (lexicográfico). compareValues no es un orden
+// estricto con columnas mixtas: "2" < "10" < "1a" < "2".
+int orderValues(const std::string& a, const std::string& b);
+
+// Convertir un texto completo a número (false si no lo es). Solo se admiten
+// decimales finitos; "nan", "inf" y los hexadecimales se tratan como texto
+bool parseNumber(const std::string& text, double& number);
+bool parseNumber(std::string_view text, double& number);
+
+// Forma canónica de un valor para las búsquedas exactas (índices hash):
+// los números se reescriben a partir de su valor, de modo que "7", "7.0"
+// y "007" dan la misma clave, igual que al compararlos; el resto no cambia
+std::string canonicalValue(const std::string& value);
+// Igual, pero añadiéndola a 'out' (sin crear una cadena por valor)
+void appendCanonicalValue(std::string& out, const std::string& value);
+
+// Hash de 64 bits coherente con compareValues: los valores numéricos se
+// hashean por su valor, de modo que "7.25" y "7.250" coinciden
+uint64_t hashValue(const std::string& value);
+uint64_t hashNumber(double number);
+
+// Comparación simple: atributo <op> constante
+// (con PREFIX se acepta el patrón 'abc%' o directamente el prefijo 'abc')
+struct Comparison {
+    std::string attribute;
+    CompareOp op;
+    std::string value;
+    bool is_numeric;        // La constante es numérica (se pre-convierte una vez)
+    double numeric_value;
+    
+    Comparison();
+    Comparison(const std::string& attr, CompareOp op_type, const std::string& val);
+    
+    // Evaluar contra un valor del registro ya extraído
+    bool matchesValue(const std::string& record_value) const;
+    bool matchesValue(std::string_view record_value) const;
+    bool matches(const Record& record) const;
+    std::string toString() const;
+};
+
+// Predicado compilado: árbol de comparaciones unidas con AND / OR.
+// Se analiza una sola vez y se compila a un árbol de closures que se
+// evalúa directamente dentro del recorrido de cada bloque.
+class Predicate {
+public:
+    enum class Kind { TRUE_CONST, COMPARISON, AND, OR };
+    
+    struct Node {
+        Kind kind;
+        Comparison comparison;
+        std::vector<Node> children;
+    };
+    
+    // Predicado que acepta todos los registros
+    Predicate();
+    
+    // Predicado de una sola comparación
+    static Predicate comparison(const std::string& attribute, CompareOp op, 
+                                const std::string& value);
+    
+    // Analizar una expresión como: Sex = 'female' AND (Pclass = 1 OR Age < 30)
+    // Devuelve false y rellena 'error' si la expresión no es válida
+    static bool parse(const std::string& expression, Predicate& result, std::string& error);
+    
+    bool evaluate(const Record& record) const { return compiled(record); }
+    // Evaluar sobre una vista: solo se decodifican los campos referenciados
+    bool evaluate(const RecordView& view) const;
+    
+    // Comparaciones unidas por AND en la raíz (candidatas para usar índices)
+    std::vector<Comparison> getConjuncts() const;
+    
+    // Atributos referenciados por el predicado
+    std::set<std::string> getAttributes() const;
+    
+    const Node& getRoot() const { return *root; }
+    bool isTrue() const { return root->kind == Kind::TRUE_CONST; }
+    
+    // Forma normalizada del predicado (con paréntesis explícitos)
+    std::string toString() const;
+    // Igual, con los operandos de AND / OR ordenados: clave estable para
+    // predicados equivalentes escritos en distinto orden
+    std::string toCanonicalString() const;
+    
+private:
+    std::shared_ptr<const Node> root;
+    std::function<bool(const Record&)> compiled;
+    
+    explicit Predicate(Node node);
+    static std::function<bool(const Record&)> compile(const Node& node);
+};
+
+#endif // QUERY_H
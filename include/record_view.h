@@ -0,0 +1,37 @@
+#ifndef RECORD_VIEW_H
+#define RECORD_VIEW_H
+
+#include "compression.h"
+#include <functional>
+
+// Vista ligera de un registro, sin copiarlo. Apunta a un Record residente
+// en un bloque fijado o a una fila de un EncodedBlock leído de disco; en
+// este último caso cada campo se decodifica solo cuando se pide. La vista
+// y los valores que entrega son válidos mientras dure el recorrido que la
+// produjo: materialize() construye un Record propio cuando hace falta
+// conservarlo.
+class RecordView {
+private:
+    const Record* record;         // Registro residente (nullptr si es una fila codificada)
+    const EncodedBlock* block;
+    size_t row;
+    
+public:
+    explicit RecordView(const Record& resident);
+    RecordView(const EncodedBlock& encoded, size_t row_index);
+    
+    int getId() const;
+    bool isDeleted() const;
+    bool isEncoded() const;
+    
+    // Valor de un atributo; false si el registro no lo tiene
+    bool get(const std::string& attribute, std::string_view& value) const;
+    
+    // Recorrer los campos en orden de nombre de atributo
+    void forEachField(const std::function<void(std::string_view, std::string_view)>& visitor) const;
+    
+    // Construir una copia completa del registro
+    Record materialize() const;
+};
+
+#endif // RECORD_VIEW_H
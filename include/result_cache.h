@@ -0,0 +1,60 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "sgbd_basic.h"
+#include <list>
+#include <set>
+#include <unordered_map>
+
+// Caché de resultados de consultas: predicado normalizado -> IDs de registro.
+// Cada entrada recuerda la tabla y los atributos del predicado; una escritura
+// solo invalida las entradas de su tabla que leen alguno de los atributos
+// modificados. La capacidad está acotada en bytes y se desaloja por LRU.
+class ResultCache {
+private:
+    struct Entry {
+        std::string table;                    // Vacío: consulta sobre todas las tablas
+        std::set<std::string> attributes;     // Vacío: depende de cualquier atributo
+        std::vector<int> record_ids;
+        size_t bytes;
+        std::list<std::string>::iterator lru_position;
+    };
+    
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lru_list;    // Frente: entrada usada más recientemente
+    size_t max_bytes;
+    size_t used_bytes;
+    
+    long long hits;
+    long long misses;
+    long long invalidations;
+    
+    void erase(std::unordered_map<std::string, Entry>::iterator it);
+    bool dependsOn(const Entry& entry, const std::string& table,
+                   const std::set<std::string>& attributes) const;
+    
+public:
+    ResultCache(size_t capacity_bytes = 0);
+    
+    // Capacidad 0 desactiva la caché y descarta su contenido
+    void setCapacity(size_t capacity_bytes);
+    bool isEnabled() const;
+    
+    static std::string makeKey(const std::string& table, const std::string& predicate);
+    
+    // IDs cacheados para la clave (nullptr si no está)
+    const std::vector<int>* lookup(const std::string& key);
+    void insert(const std::string& key, const std::string& table,
+                const std::set<std::string>& attributes, const std::vector<int>& record_ids);
+    
+    // Invalidar las entradas afectadas por una escritura en 'table'
+    // que toca los atributos indicados
+    void invalidate(const std::string& table, const std::set<std::string>& attributes);
+    void invalidate(const std::string& table, const Record& record);
+    void clear();
+    
+    size_t getMemoryUsage() const;
+    void print() const;
+};
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,87 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "sgbd.h"
+#include "protocol.h"
+#include <atomic>
+#include <unordered_map>
+
+// Servidor local del SGBD sobre un socket de dominio Unix.
+// Un único hilo atiende todas las conexiones con epoll: en cada vuelta lee
+// lo que haya llegado de cada conexión lista, decodifica todas las tramas
+// completas y las ejecuta como un lote sobre la instancia compartida. Las
+// inserciones consecutivas en la misma tabla se agrupan en addRecords. Las
+// respuestas se acumulan por conexión y se envían con una escritura por
+// conexión al final del lote.
+class SGBDServer {
+private:
+    // Respuestas pendientes a partir de las cuales se deja de leer una conexión
+    static const size_t MAX_PENDING_OUTPUT = 4 * 1024 * 1024;
+    static const int MAX_EVENTS = 128;
+    // Margen para los campos fijos y el mensaje de una respuesta a QUERY
+    static const size_t MAX_RESPONSE_HEADER_BYTES = 1024;
+
+    struct Connection {
+        int fd;
+        std::string input;
+        size_t input_offset;
+        std::string output;
+        size_t output_offset;
+        uint32_t events;     // Eventos registrados en epoll
+        bool closing;        // Cerrar cuando se vacíe la salida
+
+        Connection(int socket_fd = -1);
+    };
+
+    struct PendingRequest {
+        int fd;
+        protocol::Request request;
+        std::string error;  // No vacío si la trama no se pudo decodificar
+    };
+
+    SGBD& system;
+    std::string socket_path;
+    int listen_fd;
+    int epoll_fd;
+    bool verbose;  // Mostrar los mensajes del SGBD mientras se atienden peticiones
+    std::atomic<bool> running;
+    std::unordered_map<int, Connection> connections;
+
+    // Métricas
+    long long requests_served;
+    long long batches_executed;
+    long long largest_batch;
+    long long inserts_coalesced;  // Inserciones ejecutadas dentro de un addRecords
+    long long connections_accepted;
+    long long protocol_errors;
+
+    void acceptConnections();
+    // Leer hasta vaciar el socket y pasar las tramas completas al lote
+    void readConnection(Connection& connection, std::vector<PendingRequest>& batch);
+    // Escribir la salida pendiente sin bloquear
+    void flushConnection(Connection& connection);
+    // Ajustar el interés en epoll según la salida pendiente
+    void updateEvents(Connection& connection);
+    void closeConnection(int fd);
+
+    void executeBatch(std::vector<PendingRequest>& batch);
+    void executeInserts(std::vector<PendingRequest>& batch, size_t begin, size_t end);
+    void executeRequest(const protocol::Request& request, std::string& output);
+
+public:
+    SGBDServer(SGBD& database, const std::string& path, bool verbose_output = false);
+    ~SGBDServer();
+
+    // Crear el socket de escucha y la instancia de epoll
+    bool start(std::string& error);
+
+    // Atender peticiones hasta que se llame a stop()
+    void run();
+
+    // Seguro desde un manejador de señales
+    void stop();
+
+    void printStats() const;
+};
+
+#endif // SERVER_H
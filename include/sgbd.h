@@ -2,45 +2,312 @@
 #define SGBD_H
 
 #include "disk_manager.h"
+#include "index.h"
+#include "aggregate.h"
+#include "catalog.h"
+#include "join.h"
+#include "sort.h"
+#include "result_cache.h"
+#include "background_writer.h"
+#include "record_view.h"
+#include "snapshot.h"
 #include <algorithm>
+#include <cmath>
 
 // Sistema Gestor de Base de Datos Principal
 class SGBD {
 private:
+    // Fracción máxima de la tabla que puede seleccionar un índice para usarlo
+    static constexpr double INDEX_SELECTIVITY_THRESHOLD = 0.25;
+    static const int HISTOGRAM_BUCKETS = 16;
+    
     DiskManager disk_manager;
     std::unordered_map<int, Block*> all_blocks;
     int next_record_id;
+    int next_block_id;
+    double fill_factor;     // Espacio reservado en cada bloque para actualizaciones
+    Catalog catalog;        // Tablas con nombre, cada una con su heap de bloques
+    
+    std::unordered_map<int, int> record_block;      // record_id -> block_id
+    std::map<std::string, HashIndex> indexes;       // Índices secundarios por atributo
+    std::map<std::string, PrefixIndex> prefix_indexes;  // Índices de prefijos (LIKE 'abc%')
+    ResultCache result_cache;                       // Desactivada hasta fijar su capacidad
+    
+    // Mensajes de cada operación: std::cout, o nada en modo silencioso.
+    // Los informes show* y print* se escriben siempre en std::cout.
+    std::ostream output;
+    
+    // Latch del motor: cada operación pública lo mantiene mientras se ejecuta
+    // y el escritor en segundo plano lo toma para cada bloque que escribe.
+    // Es recursivo porque unas operaciones públicas llaman a otras.
+    std::recursive_mutex latch;
+    BackgroundWriter background_writer;
+    
+    // Métricas de los filtros de Bloom
+    long long bloom_probes;           // Bloques en los que se consultó algún filtro
+    long long bloom_skips;            // Bloques descartados por un filtro
+    long long bloom_false_positives;  // Bloques admitidos por el filtro sin resultados
+    
+    // Buffers para leer bloques codificados sin pasar por el buffer pool.
+    // Se reutilizan entre llamadas; una llamada anidada desde un consumidor
+    // usa unos propios.
+    struct ViewBuffers {
+        std::string bytes;
+        EncodedBlock block;
+    };
+    ViewBuffers view_buffers;
+    bool view_buffers_busy;
+    
+    // Reserva de view_buffers mientras dura un recorrido. Si ya están en uso
+    // (llamada anidada) entrega unos locales. La reserva se devuelve al
+    // destruirse, también si el consumidor lanza una excepción.
+    class ViewBuffersLease {
+    private:
+        ViewBuffers local;
+        ViewBuffers* buffers;
+        bool* busy;      // nullptr si se usan los locales
+        
+    public:
+        ViewBuffersLease(ViewBuffers& shared, bool& shared_busy);
+        ~ViewBuffersLease();
+        ViewBuffersLease(const ViewBuffersLease&) = delete;
+        ViewBuffersLease& operator=(const ViewBuffersLease&) = delete;
+        
+        ViewBuffers& get();
+    };
+    
+    // Métricas de los recorridos con vistas
+    long long view_rows;              // Registros entregados como vista
+    long long view_resident_blocks;   // Bloques recorridos en memoria
+    long long view_encoded_blocks;    // Bloques leídos codificados de disco
+    long long view_columns_decoded;   // Columnas localizadas en esos bloques
+    
+    // Instantánea cargada cuyo mapa de ubicaciones e índices aún no se han
+    // reconstruido: se restauran, en paralelo, la primera vez que hacen falta.
+    // Los nombres de los índices permiten rehacerlos desde los bloques si su
+    // sección está dañada, y saber si una consulta puede necesitarlos.
+    std::unique_ptr<SnapshotFile> deferred_snapshot;
+    std::vector<std::string> deferred_hash_indexes;
+    std::vector<std::string> deferred_prefix_indexes;
+    
+    // Completar la carga de la instantánea pendiente (nada si no la hay)
+    void restoreDeferred();
+    bool restoreLocator(const SnapshotFile& file, std::string& error);
+    bool restoreIndexes(const SnapshotFile& file, std::string& error);
+    
+    // Crear y almacenar un bloque nuevo de la tabla con capacidad para al menos 'min_bytes'
+    Block* createBlock(Table* table, int min_bytes);
+    
+    Table* getOrCreateTable(const std::string& table_name);
+    
+    // Colocar un registro en el heap de la tabla y mantener índices y
+    // estadísticas, sin medir tiempos ni imprimir (nullptr si no hay espacio).
+    // 'heap_full' permite a un lote recordar que el heap ya no tiene hueco.
+    Block* placeRecord(Table* table, const Record& record, bool* heap_full = nullptr);
+    
+    // Registrar en una tabla un bloque creado fuera de addRecord
+    void attachBlock(Table* table, Block* block);
+    
+    // Bloques de una tabla (todas las tablas si el nombre está vacío)
+    std::vector<Block*> getTableBlocks(const std::string& table_name);
+    
+    // Acceso a los bloques a través del buffer: fetchBlock los recarga desde
+    // disco si fueron desalojados. Los operadores fijan cada bloque solo
+    // mientras lo recorren (BlockPin) y copian lo que necesitan conservar.
+    Block* fetchBlock(Block* block);
+    
+    // Descartar con los zone maps y los filtros de Bloom los bloques que no
+    // pueden cumplir el predicado. 'bloom_consulted' (opcional) indica, para
+    // cada candidato, si algún filtro de Bloom lo admitió.
+    std::vector<Block*> pruneBlocks(const std::vector<Block*>& blocks, 
+                                    const Predicate& predicate, int& skipped,
+                                    std::vector<bool>* bloom_consulted = nullptr);
+    
+    // Leer un bloque no residente en formato codificado (false si no se puede)
+    bool readEncodedBlock(const Block* block, ViewBuffers& buffers);
+    
+    // Mantener el mapa de ubicaciones y los índices secundarios
+    void indexRecord(const Record& record, int block_id);
+    void unindexRecord(const Record& record);
+    Block* findBlockOfRecord(int record_id);
+    
+    // Cardinalidad estimada con las estadísticas de columna
+    double estimateRows(const Predicate& predicate, const std::string& table_name) const;
+    
+    // Evaluar un predicado eligiendo entre índice y recorrido completo.
+    // Cada registro que lo cumple se entrega al consumidor mientras su
+    // bloque está cargado; el consumidor no debe cargar otros bloques.
+    void executeQuery(const Predicate& predicate, const std::string& table_name,
+                      const std::function<void(const Record&)>& consumer);
+    
+    // Resolver una lista de IDs a registros (filtrando por tabla y, si se
+    // indica, por el predicado), con el mismo contrato que executeQuery
+    void fetchRecords(const std::vector<int>& record_ids, const std::string& table_name,
+                      const Predicate* predicate,
+                      const std::function<void(const Record&)>& consumer);
+    
+    // Desglose de memoria por componente
+    void printMemoryUsage();
     
 public:
+    // 'buffer_bytes' es el presupuesto de memoria del buffer pool para los
+    // registros de los bloques cargados
     SGBD(int platters, int surfaces, int tracks, int sectors, 
-         int sector_cap, int rec_per_block, int buffer_size);
+         int sector_cap, size_t buffer_bytes, int block_size = 0,
+         double fill = 0.9);
+    ~SGBD();
     
-    // Cargar datos desde archivo CSV
-    bool loadFromCSV(const std::string& filename);
+    // Mostrar (true, por defecto) u omitir los mensajes de cada operación,
+    // también los del disco y el buffer. Solo afecta a esta instancia.
+    void setVerbose(bool verbose);
+    
+    // Crear una tabla vacía en el catálogo
+    bool createTable(const std::string& name, const std::vector<std::string>& schema);
+    
+    // Cargar datos desde archivo CSV (por defecto en la tabla con el nombre del fichero)
+    bool loadFromCSV(const std::string& filename, const std::string& table_name = "");
     
     // Añadir un registro individual
-    bool addRecord(const Record& record);
+    bool addRecord(const Record& record, const std::string& table_name = "default");
+    
+    // Reservar un ID de registro libre para un registro nuevo
+    int allocateRecordId();
+    
+    // Añadir un lote de registros amortizando la búsqueda de bloque y los
+    // mensajes; devuelve cuántos se insertaron. Si se pasa 'stored', indica
+    // para cada registro del lote si se insertó.
+    int addRecords(const std::vector<Record>& batch, const std::string& table_name = "default",
+                   std::vector<bool>* stored = nullptr);
+    
+    // UPDATE ... SET atributo = valor WHERE predicado. Los registros se modifican
+    // en su bloque si siguen cabiendo (margen del fill factor); si no, se
+    // reubican conservando su ID. Devuelve cuántos se actualizaron.
+    int updateRecords(const std::string& where, 
+                      const std::map<std::string, std::string>& assignments,
+                      const std::string& table_name = "");
+    int updateRecords(const Predicate& predicate, 
+                      const std::map<std::string, std::string>& assignments,
+                      const std::string& table_name = "");
+    
+    // Consultar un registro por ID: lo copia en 'record' (false si no existe)
+    bool findRecord(int record_id, Record& record);
+    
+    // Consultar registros por atributo (en todas las tablas si no se indica una)
+    std::vector<Record> findRecordsByAttribute(const std::string& attribute, 
+                                              const std::string& value, 
+                                              const std::string& operator_type = "=",
+                                              const std::string& table_name = "");
+    
+    // Consultar con una expresión compuesta, p. ej. "Sex = 'female' AND Pclass <= 2".
+    // Devuelven copias de los registros: los bloques se sueltan al recorrerlos
+    // y el buffer puede desalojarlos en cuanto termina la consulta.
+    std::vector<Record> query(const std::string& expression, 
+                              const std::string& table_name = "");
+    std::vector<Record> query(const Predicate& predicate, 
+                              const std::string& table_name = "");
+    
+    // Recorrido sin materializar registros: entrega una vista de cada
+    // registro activo que cumple el predicado, hasta que el consumidor
+    // devuelva false. Los bloques residentes se recorren fijados; los demás
+    // se leen codificados de disco sin cargarlos en el buffer pool, y de
+    // ellos solo se decodifican las columnas que se consultan. El consumidor
+    // no debe modificar la tabla. Devuelve cuántos registros se entregaron.
+    long long scan(const Predicate& predicate,
+                   const std::function<bool(const RecordView&)>& consumer,
+                   const std::string& table_name = "");
+    
+    // Búsqueda por ID por el mismo camino (false si el registro no existe)
+    bool lookup(int record_id, const std::function<void(const RecordView&)>& consumer);
+    
+    // Agregación con GROUP BY, p. ej. aggregate({"Pclass"}, {"AVG(Fare)", "COUNT(*)"})
+    std::vector<AggregateRow> aggregate(const std::vector<std::string>& group_by,
+                                        const std::vector<std::string>& aggregates,
+                                        const std::string& where = "",
+                                        const std::string& table_name = "");
+    
+    // Hash join por igualdad entre dos tablas. Si la tabla menor no cabe en
+    // 'memory_budget' bytes (por defecto, el tamaño del buffer pool) se usa
+    // la variante grace con particiones en disco
+    std::vector<JoinedRow> hashJoin(const std::string& left_table, const std::string& left_key,
+                                    const std::string& right_table, const std::string& right_key,
+                                    long long memory_budget = 0);
     
-    // Consultar un registro por ID
-    Record* findRecord(int record_id);
+    // ORDER BY, p. ej. orderBy("titanic", "Fare DESC, Name", 3). Devuelve copias
+    // de los registros, ya que el buffer puede invalidar los punteros.
+    // Si los registros no caben en 'memory_budget' se usa ordenación externa.
+    std::vector<Record> orderBy(const std::string& table_name, const std::string& order_by,
+                                size_t limit = 0, const std::string& where = "",
+                                long long memory_budget = 0);
     
-    // Consultar registros por atributo
-    std::vector<Record*> findRecordsByAttribute(const std::string& attribute, 
-                                               const std::string& value, 
-                                               const std::string& operator_type = "=");
+    // Variante en streaming: entrega cada registro ordenado al consumidor
+    bool orderBy(const std::string& table_name, const std::string& order_by,
+                 const std::function<bool(const Record&)>& consumer,
+                 size_t limit = 0, const std::string& where = "",
+                 long long memory_budget = 0);
     
-    // Obtener todos los registros (SELECT * FROM table)
-    std::vector<Record*> getAllRecords();
+    // Crear un índice hash secundario sobre un atributo
+    bool createIndex(const std::string& attribute);
+    
+    // Crear un índice de prefijos sobre un atributo de texto para las
+    // consultas LIKE 'abc%'
+    bool createPrefixIndex(const std::string& attribute);
+    
+    // Activar la caché de resultados de query() / findRecordsByAttribute()
+    // con una capacidad en bytes (0 la desactiva)
+    void setResultCacheCapacity(size_t capacity_bytes);
+    
+    // Arrancar / detener el hilo que vuelca bloques sucios y hace
+    // checkpoints difusos periódicos dentro de un presupuesto de E/S
+    bool startBackgroundWriter(const WriterConfig& config = WriterConfig());
+    void stopBackgroundWriter();
+    // Hacer que el escritor complete una ronda ahora y esperarla (false si
+    // no está en marcha); permite usarlo en pruebas sin depender de tiempos
+    bool runBackgroundWriterRound();
+    
+    // Desalojos del buffer hasta ahora y cuántos tuvieron que escribir la
+    // víctima en primer plano
+    void getEvictionStats(long long& evictions, long long& dirty_evictions);
+    
+    // Checkpoint difuso: se anotan los bloques sucios actuales y se escriben
+    // sin detener las operaciones. Sin escritor en segundo plano se completa
+    // aquí mismo.
+    void checkpoint();
+    
+    // Recalcular las estadísticas de columna (distintos, nulos, anchura media
+    // e histogramas equi-depth) de una tabla, o de todas si no se indica
+    bool analyze(const std::string& table_name = "");
+    
+    // Mantener un filtro de Bloom por bloque sobre una columna de la tabla,
+    // con la tasa de falsos positivos objetivo indicada
+    bool createBloomFilter(const std::string& table_name, const std::string& column,
+                           double fpr = 0.01);
+    
+    // Obtener copias de todos los registros (SELECT * FROM table)
+    std::vector<Record> getAllRecords(const std::string& table_name = "");
     
     // Eliminar un registro
     bool deleteRecord(int record_id);
     
+    // Guardar el estado completo (disco, catálogo, metadatos de los bloques,
+    // mapa de ubicaciones e índices) en un fichero binario versionado con
+    // checksums, tras volcar los bloques sucios
+    bool saveSnapshot(const std::string& path);
+    
+    // Abrir una instantánea en una instancia vacía con la misma geometría de
+    // disco. El fichero se mapea en memoria; el disco se restaura en paralelo
+    // con el catálogo y los bloques, que quedan sin cargar en el buffer. El
+    // mapa de ubicaciones y los índices se reconstruyen al primer uso.
+    bool loadSnapshot(const std::string& path);
+    
     // Mostrar contenido de un bloque específico
     void showBlockContent(int block_id);
     
     // Mostrar todos los bloques
     void showAllBlocks();
     
+    // Mostrar las tablas del catálogo
+    void showCatalog();
+    
     // Mostrar estadísticas del sistema
     void showSystemStats();
     
@@ -54,5 +321,6 @@ public:
 // Funciones auxiliares para crear datos de ejemplo
 void createTitanicSample();
 void createHousingSample();
+void createPortsSample();
 
 #endif // SGBD_H
\ No newline at end of file
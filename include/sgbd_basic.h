@@ -29,6 +29,20 @@ struct PhysicalLocation {
     
     PhysicalLocation(int p = -1, int s = -1, int t = -1, int sec = -1, int pos = -1);
     void print() const;
+    void print(std::ostream& out) const;
+};
+
+// Extensión: rango de sectores contiguos dentro de una misma pista.
+// Un bloque se almacena como una lista ordenada de extensiones (extent map).
+struct Extent {
+    int platter_id;
+    int surface_id;
+    int track_id;
+    int start_sector;
+    int sector_count;
+    
+    Extent(int p = -1, int s = -1, int t = -1, int start = -1, int count = 0);
+    void print() const;
 };
 
 // Estructura para representar un registro
@@ -50,34 +64,69 @@ public:
     // Obtener tamaño del registro en bytes
     int getSize() const;
     
+    // Memoria real ocupada en el heap por el registro (nodos del mapa y
+    // cadenas), sin contar el propio objeto Record
+    size_t getHeapMemory() const;
+    
     void print() const;
 };
 
+// Bytes reservados en el heap por una cadena (0 si cabe en el buffer interno)
+size_t stringHeapMemory(const std::string& text);
+
 // Estructura física del disco - Sector
 class Sector {
 public:
     int sector_id;
     int capacity;
-    std::vector<char> data;
+    std::vector<char> data;  // Solo los bytes escritos: vacío hasta la primera escritura
     int used_space;
+    bool allocated;  // Reservado por la extensión de algún bloque
     
     Sector(int id, int cap);
     bool hasSpace(int required_space) const;
+    bool isFree() const;
+    void clear();
+    // Vaciar y devolver la memoria del contenido (sector liberado)
+    void release();
     bool writeData(const std::string& content, int& position);
     std::string readData(int position, int length) const;
+    size_t getMemoryUsage() const;
     void print() const;
 };
 
 // Estructura física del disco - Pista (Track)
+// Los sectores de una pista no se crean hasta que se reserva alguno: una
+// pista sin tocar solo ocupa sus metadatos y se considera libre por completo.
 class Track {
 public:
     int track_id;
-    std::vector<Sector> sectors;
+    std::vector<Sector> sectors;  // Vacío mientras la pista no se ha tocado
     int sectors_per_track;
+    int sector_capacity;
+    int free_sectors;             // Sectores sin reservar
     
     Track(int id, int num_sectors, int sector_capacity);
-    Sector* findSectorWithSpace(int required_space);
+    bool isMaterialized() const;
+    // Acceso a un sector, creando los de la pista si aún no existen
+    Sector& getSector(int index);
+    // nullptr si la pista no se ha tocado
+    const Sector* peekSector(int index) const;
+    // Marcar / desmarcar como reservados los sectores [start, start + count)
+    void reserveSectors(int start, int count);
+    void releaseSectors(int start, int count);
+    
+    // Buscar una secuencia de sectores libres contiguos (devuelve -1 si no hay)
+    int findFreeRun(int count) const;
+    // Primera secuencia de sectores libres que empieza en 'from' o después
+    // (devuelve su longitud, 0 si no hay ninguna)
+    int nextFreeRun(int from, int& start) const;
+    long long getUsedSpace() const;
+    size_t getMemoryUsage() const;
     void print() const;
+    
+private:
+    void materialize();
 };
 
 // Estructura física del disco - Superficie
@@ -88,7 +137,6 @@ public:
     int tracks_per_surface;
     
     Surface(int id, int num_tracks, int sectors_per_track, int sector_capacity);
-    Track* findTrackWithSpace(int required_space);
     void print() const;
 };
 
@@ -101,7 +149,6 @@ public:
     
     Platter(int id, int num_surfaces, int tracks_per_surface, 
             int sectors_per_track, int sector_capacity);
-    Surface* findSurfaceWithSpace(int required_space);
     void print() const;
 };
 
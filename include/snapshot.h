@@ -0,0 +1,111 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+// Codificación binaria de las instantáneas: enteros little-endian de ancho
+// fijo, reales por sus bits y cadenas con longitud de 32 bits
+class SnapshotWriter {
+private:
+    std::string& out;
+    
+public:
+    explicit SnapshotWriter(std::string& buffer);
+    
+    void putU8(uint8_t value);
+    void putU32(uint32_t value);
+    void putU64(uint64_t value);
+    void putI32(int value);
+    void putI64(long long value);
+    void putDouble(double value);
+    void putString(const std::string& value);
+    void putBytes(const char* data, size_t length);
+};
+
+// Lectura sobre una sección ya en memoria (normalmente el fichero mapeado);
+// cada get devuelve false si se acaban los datos
+class SnapshotReader {
+private:
+    const char* data;
+    size_t size;
+    size_t pos;
+    
+public:
+    SnapshotReader(const char* bytes = nullptr, size_t length = 0);
+    
+    bool getU8(uint8_t& value);
+    bool getU32(uint32_t& value);
+    bool getU64(uint64_t& value);
+    bool getI32(int& value);
+    bool getI64(long long& value);
+    bool getDouble(double& value);
+    bool getBool(bool& value);
+    bool getString(std::string& value);
+    // Sin copiar: 'bytes' apunta a los datos de la sección
+    bool getBytes(const char*& bytes, size_t length);
+    // Número de elementos que sigue, acotado por los bytes que quedan para
+    // que una longitud corrupta no provoque reservas enormes
+    bool getCount(uint32_t& count, size_t min_element_bytes);
+    bool atEnd() const;
+};
+
+// Checksum de 64 bits de una sección. Procesa palabras de 8 bytes para que
+// verificar secciones grandes cueste poco más que leerlas.
+uint64_t snapshotChecksum(const char* data, size_t length);
+
+enum class SnapshotSection : uint32_t {
+    DISK = 1,       // Geometría, mapa de sectores reservados y su contenido
+    CATALOG = 2,    // Contadores, tablas con sus estadísticas y definición de índices
+    BLOCKS = 3,     // Metadatos de los bloques: extent map, zone maps, filtros de Bloom
+    LOCATOR = 4,    // record_id -> block_id
+    INDEXES = 5     // Contenido de los índices hash y de prefijos
+};
+
+// Fichero de instantánea: cabecera con versión, tabla de secciones (posición,
+// tamaño y checksum de cada una) y las secciones alineadas a 8 bytes. Se lee
+// con mmap: abrirlo solo valida la cabecera y la tabla, y cada sección se
+// verifica cuando se pide.
+class SnapshotFile {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+    
+    SnapshotFile();
+    ~SnapshotFile();
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+    
+    // Escribir las secciones en un fichero temporal y renombrarlo, de modo
+    // que una instantánea anterior no queda a medias si algo falla
+    static bool write(const std::string& path,
+                      const std::vector<std::pair<SnapshotSection, std::string>>& sections,
+                      std::string& error);
+    
+    bool open(const std::string& path, std::string& error);
+    void close();
+    
+    bool hasSection(SnapshotSection id) const;
+    // Verificar el checksum de la sección y preparar un lector sobre ella
+    bool openSection(SnapshotSection id, SnapshotReader& reader, std::string& error) const;
+    
+    const std::string& getPath() const;
+    size_t getSize() const;
+    
+private:
+    struct Entry {
+        uint32_t id;
+        uint64_t offset;
+        uint64_t length;
+        uint64_t checksum;
+    };
+    
+    std::string path;
+    int fd;
+    const char* base;
+    size_t length;
+    std::vector<Entry> entries;
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,58 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include "disk_manager.h"
+#include <memory>
+
+// Clave de ordenación: atributo y sentido
+struct SortKey {
+    std::string attribute;
+    bool ascending;
+    
+    SortKey(const std::string& attr = "", bool asc = true);
+    
+    // Analizar una lista como "Fare DESC, Name"; devuelve false si no es válida
+    static bool parseList(const std::string& text, std::vector<SortKey>& keys);
+};
+
+// Operador ORDER BY.
+// - Con LIMIT k se mantiene un heap acotado de k registros (top-K).
+// - Si los registros caben en el presupuesto de memoria se ordenan en memoria.
+// - Si no, se generan runs ordenados que se vuelcan a ficheros temporales del
+//   disco y se combinan con un merge de k vías leyendo página a página.
+// Los valores se ordenan con orderValues (números antes que textos) y los
+// ausentes o vacíos van primero en ASC.
+class SortOperator {
+private:
+    DiskManager* disk;
+    std::vector<SortKey> keys;
+    long long memory_budget;
+    size_t limit;       // 0 = sin límite
+    int runs_spilled;   // Runs escritos al disco en la última ejecución
+    int merge_passes;   // Pasadas completas sobre los runs (la última incluida)
+    
+    class RunReader;
+    
+    bool spillRun(std::vector<Record>& run, std::vector<std::unique_ptr<SpillFile>>& runs);
+    bool mergeRuns(std::vector<std::unique_ptr<SpillFile>>& runs,
+                   const std::function<bool(const Record&)>& consumer,
+                   SpillFile* output);
+    
+public:
+    SortOperator(DiskManager* disk_manager, const std::vector<SortKey>& sort_keys,
+                 long long budget_bytes, size_t max_rows = 0);
+    
+    // Devuelve true si 'a' va antes que 'b'
+    bool less(const Record& a, const Record& b) const;
+    
+    // Entregar los registros ordenados al consumidor (que puede devolver
+    // false para detener la ejecución). Cada bloque se fija solo mientras se
+    // copian sus registros; devuelve false si alguno no se pudo cargar.
+    bool execute(const std::vector<Block*>& blocks, const Predicate& filter,
+                 const std::function<bool(const Record&)>& consumer);
+    
+    int getRunCount() const;
+    int getMergePasses() const;
+};
+
+#endif // SORT_H
@@ -0,0 +1,97 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "query.h"
+#include "snapshot.h"
+
+// Sketch HyperLogLog para estimar el número de valores distintos de una
+// columna en memoria constante (2^PRECISION registros de un byte)
+class HyperLogLog {
+private:
+    static const int PRECISION = 10;
+    static const int REGISTERS = 1 << PRECISION;
+    std::vector<uint8_t> registers;
+    
+public:
+    HyperLogLog();
+    void add(const std::string& value);
+    void clear();
+    double estimate() const;
+    size_t getMemoryUsage() const;
+    
+    void save(SnapshotWriter& out) const;
+    bool load(SnapshotReader& in);
+};
+
+// Histograma equi-depth: cada cubeta contiene aproximadamente el mismo
+// número de valores. Se construye en ANALYZE y se ajusta al insertar.
+class EquiDepthHistogram {
+public:
+    struct Bucket {
+        std::string upper;      // Mayor valor de la cubeta (inclusive)
+        long long count;        // Valores en la cubeta
+        long long distinct;     // Valores distintos en la cubeta
+    };
+    
+private:
+    std::string lower;          // Menor valor del histograma
+    bool numeric;               // Todos los valores son números (interpolación lineal)
+    std::vector<Bucket> buckets;
+    long long total;
+    
+    int findBucket(const std::string& value) const;
+    // Fracción de la cubeta que queda por debajo de 'value'
+    double fractionInBucket(int bucket, const std::string& value) const;
+    
+public:
+    EquiDepthHistogram();
+    
+    // 'values' debe estar ordenado con compareValues
+    void build(const std::vector<std::string>& values, int max_buckets);
+    void add(const std::string& value);
+    void remove(const std::string& value);
+    bool isEmpty() const;
+    
+    // Fracción estimada de valores que cumplen la comparación
+    double estimateSelectivity(const Comparison& comparison) const;
+    
+    const std::vector<Bucket>& getBuckets() const;
+    size_t getMemoryUsage() const;
+    void print() const;
+    
+    void save(SnapshotWriter& out) const;
+    bool load(SnapshotReader& in);
+};
+
+// Estadísticas de una columna: distintos, nulos, anchura media e histograma
+class ColumnStats {
+private:
+    HyperLogLog distinct_sketch;
+    EquiDepthHistogram histogram;
+    long long value_count;      // Registros activos con valor no vacío
+    long long total_width;      // Bytes acumulados de esos valores
+    
+public:
+    ColumnStats();
+    
+    void add(const std::string& value);
+    void remove(const std::string& value);
+    // Recalcular desde cero con todos los valores activos de la columna
+    void rebuild(std::vector<std::string> values, int histogram_buckets);
+    
+    double getDistinctCount() const;
+    double getNullFraction(long long row_count) const;
+    double getAverageWidth() const;
+    long long getValueCount() const;
+    bool hasHistogram() const;
+    size_t getMemoryUsage() const;
+    
+    // Fracción estimada de registros (sobre 'row_count') que cumplen la comparación
+    double estimateSelectivity(const Comparison& comparison, long long row_count) const;
+    void print(const std::string& column, long long row_count) const;
+    
+    void save(SnapshotWriter& out) const;
+    bool load(SnapshotReader& in);
+};
+
+#endif // STATISTICS_H
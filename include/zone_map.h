@@ -0,0 +1,53 @@
+#ifndef ZONE_MAP_H
+#define ZONE_MAP_H
+
+#include "query.h"
+#include "snapshot.h"
+
+// Resumen de una columna dentro de un bloque: rango de valores y nulos
+struct ColumnZone {
+    std::string min_text;    // Mínimo / máximo lexicográfico
+    std::string max_text;
+    bool all_numeric;        // Todos los valores presentes son números
+    double min_number;       // Mínimo / máximo numérico (si all_numeric)
+    double max_number;
+    int value_count;         // Registros activos con el atributo
+    
+    ColumnZone();
+    void add(const std::string& value);
+    
+    // false si ningún valor del rango puede cumplir la comparación
+    bool mayMatch(const Comparison& comparison) const;
+    
+    void save(SnapshotWriter& out) const;
+    bool load(SnapshotReader& in);
+};
+
+// Zone map de un bloque: min/max y nulos por columna de los registros activos.
+// Permite descartar bloques completos antes de recorrer sus registros.
+class ZoneMap {
+private:
+    std::map<std::string, ColumnZone> columns;
+    int row_count;  // Registros activos resumidos
+    
+    bool mayMatchNode(const Predicate::Node& node) const;
+    
+public:
+    ZoneMap();
+    
+    void add(const Record& record);
+    void clear();
+    void rebuild(const std::vector<Record>& records);
+    
+    bool mayMatch(const Predicate& predicate) const;
+    
+    const ColumnZone* getColumn(const std::string& attribute) const;
+    int getNullCount(const std::string& attribute) const;
+    int getRowCount() const;
+    size_t getMemoryUsage() const;
+    
+    void save(SnapshotWriter& out) const;
+    bool load(SnapshotReader& in);
+};
+
+#endif // ZONE_MAP_H
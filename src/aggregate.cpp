@@ -0,0 +1,293 @@
+#include "aggregate.h"
+#include <atomic>
+#include <cctype>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+// Separador entre los valores de una clave de grupo compuesta
+static const char GROUP_KEY_SEPARATOR = '\x1f';
+
+// ==================== AGGREGATE SPEC ====================
+AggregateSpec::AggregateSpec(AggregateFunction func, const std::string& attr)
+    : function(func), attribute(attr) {}
+
+bool AggregateSpec::parse(const std::string& text, AggregateSpec& spec) {
+    size_t open = text.find('(');
+    size_t close = text.rfind(')');
+    if (open == std::string::npos || close == std::string::npos || close < open) {
+        return false;
+    }
+    
+    std::string name;
+    for (size_t i = 0; i < open; ++i) {
+        if (!std::isspace(static_cast<unsigned char>(text[i]))) {
+            name += static_cast<char>(std::toupper(static_cast<unsigned char>(text[i])));
+        }
+    }
+    std::string attr = text.substr(open + 1, close - open - 1);
+    attr.erase(std::remove(attr.begin(), attr.end(), ' '), attr.end());
+    if (attr == "*") attr = "";
+    
+    if (name == "COUNT") spec.function = AggregateFunction::COUNT;
+    else if (name == "SUM") spec.function = AggregateFunction::SUM;
+    else if (name == "AVG") spec.function = AggregateFunction::AVG;
+    else if (name == "MIN") spec.function = AggregateFunction::MIN;
+    else if (name == "MAX") spec.function = AggregateFunction::MAX;
+    else return false;
+    
+    if (attr.empty() && spec.function != AggregateFunction::COUNT) {
+        return false;
+    }
+    spec.attribute = attr;
+    return true;
+}
+
+std::string AggregateSpec::toString() const {
+    std::string name;
+    switch (function) {
+        case AggregateFunction::COUNT: name = "COUNT"; break;
+        case AggregateFunction::SUM: name = "SUM"; break;
+        case AggregateFunction::AVG: name = "AVG"; break;
+        case AggregateFunction::MIN: name = "MIN"; break;
+        case AggregateFunction::MAX: name = "MAX"; break;
+    }
+    return name + "(" + (attribute.empty() ? "*" : attribute) + ")";
+}
+
+// ==================== AGGREGATE STATE ====================
+AggregateState::AggregateState()
+    : count(0), sum(0), 
+      min(std::numeric_limits<double>::max()), 
+      max(std::numeric_limits<double>::lowest()) {}
+
+void AggregateState::update(double value) {
+    count++;
+    sum += value;
+    if (value < min) min = value;
+    if (value > max) max = value;
+}
+
+void AggregateState::merge(const AggregateState& other) {
+    count += other.count;
+    sum += other.sum;
+    if (other.min < min) min = other.min;
+    if (other.max > max) max = other.max;
+}
+
+// ==================== GROUP HASH TABLE ====================
+GroupHashTable::GroupHashTable(int num_states) : states_per_group(num_states) {
+    slots.assign(16, Slot{0, -1});
+}
+
+void GroupHashTable::grow() {
+    std::vector<Slot> old_slots;
+    old_slots.swap(slots);
+    slots.assign(old_slots.size() * 2, Slot{0, -1});
+    size_t mask = slots.size() - 1;
+    
+    for (const auto& slot : old_slots) {
+        if (slot.group == -1) continue;
+        size_t pos = slot.hash & mask;
+        while (slots[pos].group != -1) {
+            pos = (pos + 1) & mask;
+        }
+        slots[pos] = slot;
+    }
+}
+
+AggregateState* GroupHashTable::findOrInsert(const std::string& key, uint64_t hash) {
+    // Mantener el factor de carga por debajo de 0.5
+    if ((keys.size() + 1) * 2 > slots.size()) {
+        grow();
+    }
+    
+    size_t mask = slots.size() - 1;
+    size_t pos = hash & mask;
+    while (slots[pos].group != -1) {
+        if (slots[pos].hash == hash && keys[slots[pos].group] == key) {
+            return &states[static_cast<size_t>(slots[pos].group) * states_per_group];
+        }
+        pos = (pos + 1) & mask;
+    }
+    
+    int group = static_cast<int>(keys.size());
+    slots[pos] = Slot{hash, group};
+    keys.push_back(key);
+    states.resize(states.size() + states_per_group);
+    return &states[static_cast<size_t>(group) * states_per_group];
+}
+
+void GroupHashTable::merge(const GroupHashTable& other) {
+    for (int group = 0; group < other.getGroupCount(); ++group) {
+        const std::string& key = other.keys[group];
+        AggregateState* target = findOrInsert(key, hashValue(key));
+        const AggregateState* source = other.getStates(group);
+        for (int i = 0; i < states_per_group; ++i) {
+            target[i].merge(source[i]);
+        }
+    }
+}
+
+int GroupHashTable::getGroupCount() const {
+    return static_cast<int>(keys.size());
+}
+
+const std::string& GroupHashTable::getKey(int group) const {
+    return keys[group];
+}
+
+const AggregateState* GroupHashTable::getStates(int group) const {
+    return &states[static_cast<size_t>(group) * states_per_group];
+}
+
+// ==================== AGGREGATION OPERATOR ====================
+AggregationOperator::AggregationOperator(const std::vector<std::string>& group_attributes,
+                                         const std::vector<AggregateSpec>& aggregate_specs,
+                                         const Predicate& filter)
+    : group_by(group_attributes), specs(aggregate_specs), predicate(filter) {}
+
+void AggregationOperator::consumeBlock(const Block* block, GroupHashTable& table, 
+                                       std::string& key) const {
+    bool filtered = !predicate.isTrue();
+    
+    for (const auto& record : block->records) {
+        if (record.is_deleted) continue;
+        if (filtered && !predicate.evaluate(record)) continue;
+        
+        // Construir la clave de grupo reutilizando el buffer del hilo. Los
+        // valores van en forma canónica: "7" y "7.0" forman un solo grupo,
+        // igual que son iguales en el WHERE
+        key.clear();
+        for (size_t i = 0; i < group_by.size(); ++i) {
+            if (i > 0) key += GROUP_KEY_SEPARATOR;
+            auto it = record.data.find(group_by[i]);
+            if (it != record.data.end()) appendCanonicalValue(key, it->second);
+        }
+        
+        AggregateState* states = table.findOrInsert(key, hashValue(key));
+        for (size_t i = 0; i < specs.size(); ++i) {
+            const AggregateSpec& spec = specs[i];
+            if (spec.attribute.empty()) {
+                states[i].count++;  // COUNT(*)
+                continue;
+            }
+            
+            auto it = record.data.find(spec.attribute);
+            if (it == record.data.end() || it->second.empty()) continue;  // NULL
+            
+            // Solo los números completos, como en el WHERE: "12abc" es texto
+            double value;
+            if (!parseNumber(it->second, value)) {
+                if (spec.function == AggregateFunction::COUNT) states[i].count++;
+                continue;  // Valor no numérico
+            }
+            states[i].update(value);
+        }
+    }
+}
+
+bool AggregationOperator::execute(const std::vector<Block*>& blocks, BufferManager& buffer,
+                                  std::vector<AggregateRow>& rows, int max_threads) const {
+    int num_threads = max_threads > 0 ? max_threads 
+                                      : static_cast<int>(std::thread::hardware_concurrency());
+    // Con pocos bloques no compensa lanzar hilos
+    num_threads = std::max(1, std::min(num_threads, static_cast<int>(blocks.size()) / 4));
+    
+    int num_states = static_cast<int>(specs.size());
+    std::vector<GroupHashTable> partials(num_threads, GroupHashTable(num_states));
+    
+    // El buffer no es seguro entre hilos: cargar y soltar bloques se
+    // serializa, pero la agregación de cada bloque fijado va en paralelo
+    std::mutex buffer_mutex;
+    std::atomic<bool> failed(false);
+    
+    auto worker = [&](int thread_id) {
+        std::string key;
+        for (size_t b = thread_id; b < blocks.size() && !failed; b += num_threads) {
+            Block* block;
+            {
+                std::lock_guard<std::mutex> lock(buffer_mutex);
+                block = buffer.pinBlock(blocks[b]);
+            }
+            if (block == nullptr) {
+                failed = true;
+                break;
+            }
+            consumeBlock(block, partials[thread_id], key);
+            std::lock_guard<std::mutex> lock(buffer_mutex);
+            buffer.unpinBlock(block);
+        }
+    };
+    
+    if (num_threads == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back(worker, t);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    
+    // Combinar los agregados parciales de cada hilo
+    GroupHashTable& result = partials[0];
+    for (int t = 1; t < num_threads; ++t) {
+        result.merge(partials[t]);
+    }
+    
+    if (failed) {
+        return false;
+    }
+    
+    rows.clear();
+    rows.reserve(result.getGroupCount());
+    for (int group = 0; group < result.getGroupCount(); ++group) {
+        AggregateRow row;
+        std::istringstream key_stream(result.getKey(group));
+        std::string value;
+        while (std::getline(key_stream, value, GROUP_KEY_SEPARATOR)) {
+            row.group_values.push_back(value);
+        }
+        row.group_values.resize(group_by.size());
+        
+        const AggregateState* states = result.getStates(group);
+        for (size_t i = 0; i < specs.size(); ++i) {
+            const AggregateState& state = states[i];
+            double value_out = 0;
+            switch (specs[i].function) {
+                case AggregateFunction::COUNT: value_out = static_cast<double>(state.count); break;
+                case AggregateFunction::SUM: value_out = state.sum; break;
+                case AggregateFunction::AVG: 
+                    value_out = state.count > 0 ? state.sum / state.count : 0; break;
+                case AggregateFunction::MIN: value_out = state.count > 0 ? state.min : 0; break;
+                case AggregateFunction::MAX: value_out = state.count > 0 ? state.max : 0; break;
+            }
+            row.values.push_back(value_out);
+        }
+        rows.push_back(row);
+    }
+    return true;
+}
+
+void AggregationOperator::printResult(const std::vector<AggregateRow>& rows, std::ostream& out) const {
+    for (const auto& attribute : group_by) {
+        out << attribute << "\t";
+    }
+    for (const auto& spec : specs) {
+        out << spec.toString() << "\t";
+    }
+    out << "\n";
+    
+    for (const auto& row : rows) {
+        for (const auto& value : row.group_values) {
+            out << (value.empty() ? "NULL" : value) << "\t";
+        }
+        for (double value : row.values) {
+            out << value << "\t";
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,182 @@
+#include "background_writer.h"
+
+WriterConfig::WriterConfig(size_t bytes_per_second, int interval, int scan_depth,
+                           int checkpoint_interval, double wakeup)
+    : io_bytes_per_second(bytes_per_second), interval_ms(interval),
+      lru_scan_depth(scan_depth), checkpoint_interval_ms(checkpoint_interval),
+      wakeup_fill(wakeup) {}
+
+// ==================== BACKGROUND WRITER ====================
+BackgroundWriter::BackgroundWriter(BufferManager& buffer_manager, std::recursive_mutex& engine_latch)
+    : buffer(buffer_manager), latch(engine_latch), running(false), checkpoint_requested(false),
+      in_round(false), rounds_completed(0),
+      io_credit(0), wakeup_pending(false), last_evicted_bytes(0), eviction_window(0),
+      rounds(0), blocks_written(0), bytes_written(0) {}
+
+BackgroundWriter::~BackgroundWriter() {
+    stop();
+}
+
+bool BackgroundWriter::start(const WriterConfig& writer_config) {
+    // El aviso se registra con el latch y sin 'control_mutex': wakeup() se
+    // llama con el latch tomado y después toma 'control_mutex'
+    if (isRunning()) {
+        return false;
+    }
+    std::lock_guard<std::recursive_mutex> latch_guard(latch);
+    long long evicted = buffer.getEvictedBytes();
+    size_t fill = static_cast<size_t>(buffer.getMaxBytes() * std::max(0.0, writer_config.wakeup_fill));
+    buffer.setWriterWakeup([this] { wakeup(); }, fill);
+    
+    std::lock_guard<std::mutex> guard(control_mutex);
+    if (running) {
+        return false;
+    }
+    config = writer_config;
+    config.interval_ms = std::max(1, config.interval_ms);
+    running = true;
+    io_credit = 0;
+    wakeup_pending = false;
+    last_round = std::chrono::steady_clock::now();
+    last_evicted_bytes = evicted;
+    eviction_window = 0;
+    worker = std::thread(&BackgroundWriter::run, this);
+    return true;
+}
+
+void BackgroundWriter::stop() {
+    {
+        std::lock_guard<std::mutex> guard(control_mutex);
+        if (!running) return;
+        running = false;
+    }
+    control.notify_all();
+    round_done.notify_all();
+    // Sin el latch: el hilo puede estar esperándolo para escribir un bloque
+    worker.join();
+    
+    std::lock_guard<std::recursive_mutex> latch_guard(latch);
+    buffer.setWriterWakeup(nullptr, 0);
+}
+
+bool BackgroundWriter::isRunning() {
+    std::lock_guard<std::mutex> guard(control_mutex);
+    return running;
+}
+
+void BackgroundWriter::requestCheckpoint() {
+    {
+        std::lock_guard<std::mutex> guard(control_mutex);
+        checkpoint_requested = true;
+    }
+    control.notify_all();
+}
+
+void BackgroundWriter::wakeup() {
+    // Un aviso ya pendiente basta: los desalojos seguidos no vuelven a
+    // tomar 'control_mutex'
+    if (wakeup_pending.exchange(true)) return;
+    {
+        std::lock_guard<std::mutex> guard(control_mutex);
+    }
+    control.notify_all();
+}
+
+bool BackgroundWriter::runRound() {
+    std::unique_lock<std::mutex> lock(control_mutex);
+    if (!running) return false;
+    // Una ronda ya en curso pudo empezar antes de la llamada: esperar a la siguiente
+    long long target = rounds_completed + (in_round ? 2 : 1);
+    wakeup_pending = true;
+    control.notify_all();
+    round_done.wait(lock, [&] { return !running || rounds_completed >= target; });
+    return rounds_completed >= target;
+}
+
+void BackgroundWriter::run() {
+    auto interval = std::chrono::milliseconds(config.interval_ms);
+    auto next_checkpoint = std::chrono::steady_clock::now() +
+                           std::chrono::milliseconds(config.checkpoint_interval_ms);
+
+    std::unique_lock<std::mutex> lock(control_mutex);
+    while (running) {
+        control.wait_for(lock, interval, [this] {
+            return !running || checkpoint_requested || wakeup_pending;
+        });
+        if (!running) break;
+        wakeup_pending = false;
+
+        auto now = std::chrono::steady_clock::now();
+        bool begin_checkpoint = checkpoint_requested ||
+            (config.checkpoint_interval_ms > 0 && now >= next_checkpoint);
+        if (begin_checkpoint) {
+            checkpoint_requested = false;
+            next_checkpoint = now + std::chrono::milliseconds(config.checkpoint_interval_ms);
+        }
+
+        in_round = true;
+        lock.unlock();
+        doRound(begin_checkpoint);
+        lock.lock();
+        in_round = false;
+        rounds_completed++;
+        round_done.notify_all();
+    }
+}
+
+void BackgroundWriter::doRound(bool begin_checkpoint) {
+    rounds++;
+
+    if (begin_checkpoint) {
+        std::lock_guard<std::recursive_mutex> guard(latch);
+        // Un checkpoint que aún no terminó no se reinicia: sigue acotando
+        // el trabajo pendiente desde su inicio
+        if (!buffer.isCheckpointActive()) {
+            buffer.beginCheckpoint();
+        }
+    }
+
+    // Presupuesto por cubeta de fichas: se añade lo correspondiente al tiempo
+    // transcurrido desde la ronda anterior (las rondas adelantadas por un
+    // aviso reciben menos) sin acumular más de un periodo en reposo, y el
+    // exceso del último bloque escrito se descuenta de las rondas siguientes
+    auto now = std::chrono::steady_clock::now();
+    long long elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_round).count();
+    last_round = now;
+    long long rate = static_cast<long long>(config.io_bytes_per_second);
+    long long budget = rate * config.interval_ms / 1000;
+    io_credit = std::min(io_credit + rate * std::min<long long>(elapsed_ms, config.interval_ms) / 1000, budget);
+    
+    // La parte de la LRU que se mantiene limpia sigue al ritmo de desalojo:
+    // la memoria desalojada desde la ronda anterior, que decae a la mitad
+    // por ronda cuando los desalojos se detienen
+    {
+        std::lock_guard<std::recursive_mutex> guard(latch);
+        long long evicted = buffer.getEvictedBytes();
+        size_t recent = static_cast<size_t>(evicted - last_evicted_bytes);
+        last_evicted_bytes = evicted;
+        eviction_window = std::max(recent, eviction_window / 2);
+    }
+    
+    while (config.io_bytes_per_second == 0 || io_credit > 0) {
+        size_t written;
+        {
+            std::lock_guard<std::recursive_mutex> guard(latch);
+            written = buffer.writeCheckpointBlock();
+            if (written == 0) {
+                written = buffer.cleanLRUTail(config.lru_scan_depth, eviction_window);
+            }
+        }
+        if (written == 0) break;
+
+        io_credit -= static_cast<long long>(written);
+        blocks_written++;
+        bytes_written += static_cast<long long>(written);
+    }
+}
+
+void BackgroundWriter::printStats() {
+    std::cout << "Background writer: " << (isRunning() ? "running" : "stopped")
+              << ", " << rounds << " rounds, " << blocks_written << " blocks ("
+              << bytes_written << " bytes) written\n";
+}
@@ -0,0 +1,111 @@
+#include "bloom.h"
+#include <algorithm>
+#include <cmath>
+
+// ==================== BLOOM FILTER ====================
+BloomFilter::BloomFilter(int expected, double fpr)
+    : expected_keys(std::max(expected, 1)), inserted_keys(0), target_fpr(fpr) {
+    // Bits por clave del filtro clásico, con un 20% extra para compensar
+    // la peor distribución del filtro bloqueado
+    double bits_per_key = -std::log(target_fpr) / (std::log(2.0) * std::log(2.0)) * 1.2;
+    num_hashes = std::max(1, std::min(16, static_cast<int>(std::round(bits_per_key * 0.69))));
+    long long bits = static_cast<long long>(std::ceil(bits_per_key * expected_keys));
+    num_lines = static_cast<int>(std::max(1LL, (bits + BITS_PER_LINE - 1) / BITS_PER_LINE));
+    words.assign(static_cast<size_t>(num_lines) * WORDS_PER_LINE, 0);
+}
+
+void BloomFilter::addHash(uint64_t hash) {
+    size_t line = static_cast<size_t>((hash >> 32) % static_cast<uint64_t>(num_lines));
+    uint64_t* base = &words[line * WORDS_PER_LINE];
+    uint32_t h1 = static_cast<uint32_t>(hash);
+    uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+    for (int i = 0; i < num_hashes; ++i) {
+        uint32_t bit = (h1 + i * h2) % BITS_PER_LINE;
+        base[bit / 64] |= (1ULL << (bit % 64));
+    }
+}
+
+bool BloomFilter::mayContainHash(uint64_t hash) const {
+    size_t line = static_cast<size_t>((hash >> 32) % static_cast<uint64_t>(num_lines));
+    const uint64_t* base = &words[line * WORDS_PER_LINE];
+    uint32_t h1 = static_cast<uint32_t>(hash);
+    uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+    for (int i = 0; i < num_hashes; ++i) {
+        uint32_t bit = (h1 + i * h2) % BITS_PER_LINE;
+        if ((base[bit / 64] & (1ULL << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BloomFilter::add(const std::string& value) {
+    addHash(hashValue(value));
+    inserted_keys++;
+}
+
+bool BloomFilter::mayContain(const Comparison& comparison) const {
+    if (comparison.op != CompareOp::EQ) {
+        return true;  // Solo sirve para igualdades
+    }
+    return mayContainHash(comparison.is_numeric ? hashNumber(comparison.numeric_value)
+                                                : hashValue(comparison.value));
+}
+
+void BloomFilter::clear() {
+    std::fill(words.begin(), words.end(), 0);
+    inserted_keys = 0;
+}
+
+bool BloomFilter::isOverloaded() const {
+    return inserted_keys > expected_keys;
+}
+
+int BloomFilter::getExpectedKeys() const {
+    return expected_keys;
+}
+
+double BloomFilter::getTargetFpr() const {
+    return target_fpr;
+}
+
+double BloomFilter::estimateFpr() const {
+    long long set_bits = 0;
+    for (uint64_t word : words) {
+        set_bits += __builtin_popcountll(word);
+    }
+    double fill = static_cast<double>(set_bits) / (static_cast<double>(words.size()) * 64);
+    return std::pow(fill, num_hashes);
+}
+
+size_t BloomFilter::getMemoryBytes() const {
+    return words.size() * sizeof(uint64_t);
+}
+
+void BloomFilter::save(SnapshotWriter& out) const {
+    out.putI32(num_lines);
+    out.putI32(num_hashes);
+    out.putI32(expected_keys);
+    out.putI32(inserted_keys);
+    out.putDouble(target_fpr);
+    for (uint64_t word : words) {
+        out.putU64(word);
+    }
+}
+
+bool BloomFilter::load(SnapshotReader& in) {
+    if (!in.getI32(num_lines) || !in.getI32(num_hashes) || !in.getI32(expected_keys) ||
+        !in.getI32(inserted_keys) || !in.getDouble(target_fpr) || num_lines < 1) {
+        return false;
+    }
+    size_t count = static_cast<size_t>(num_lines) * WORDS_PER_LINE;
+    const char* bytes;
+    if (!in.getBytes(bytes, count * sizeof(uint64_t))) return false;
+    
+    SnapshotReader bits(bytes, count * sizeof(uint64_t));
+    words.resize(count);
+    for (auto& word : words) {
+        bits.getU64(word);
+    }
+    return true;
+}
@@ -0,0 +1,232 @@
+#include "catalog.h"
+#include <algorithm>
+
+// ==================== TABLE STATS ====================
+TableStats::TableStats() : row_count(0), deleted_count(0), data_bytes(0) {}
+
+// ==================== TABLE ====================
+Table::Table(const std::string& table_name, const std::vector<std::string>& columns)
+    : name(table_name), schema(columns), insert_block_id(-1), analyzed(false) {}
+
+bool Table::hasColumn(const std::string& column) const {
+    return std::find(schema.begin(), schema.end(), column) != schema.end();
+}
+
+void Table::extendSchema(const Record& record) {
+    for (const auto& pair : record.data) {
+        if (!hasColumn(pair.first)) {
+            schema.push_back(pair.first);
+        }
+    }
+}
+
+void Table::addToColumnStats(const Record& record) {
+    for (const auto& pair : record.data) {
+        column_stats[pair.first].add(pair.second);
+    }
+}
+
+void Table::removeFromColumnStats(const Record& record) {
+    for (const auto& pair : record.data) {
+        auto it = column_stats.find(pair.first);
+        if (it != column_stats.end()) {
+            it->second.remove(pair.second);
+        }
+    }
+}
+
+static double estimateNode(const Table& table, const Predicate::Node& node) {
+    switch (node.kind) {
+        case Predicate::Kind::TRUE_CONST:
+            return 1.0;
+        case Predicate::Kind::COMPARISON: {
+            auto it = table.column_stats.find(node.comparison.attribute);
+            if (it == table.column_stats.end()) return 0.0;  // Ningún registro tiene el atributo
+            return it->second.estimateSelectivity(node.comparison, table.stats.row_count);
+        }
+        case Predicate::Kind::AND: {
+            // Se asume independencia entre columnas
+            double selectivity = 1.0;
+            for (const auto& child : node.children) {
+                selectivity *= estimateNode(table, child);
+            }
+            return selectivity;
+        }
+        case Predicate::Kind::OR: {
+            double none = 1.0;
+            for (const auto& child : node.children) {
+                none *= 1.0 - estimateNode(table, child);
+            }
+            return 1.0 - none;
+        }
+    }
+    return 1.0;
+}
+
+double Table::estimateSelectivity(const Predicate& predicate) const {
+    if (stats.row_count <= 0) return 0.0;
+    return estimateNode(*this, predicate.getRoot());
+}
+
+void Table::printColumnStats() const {
+    std::cout << "Statistics for '" << name << "' (" << stats.row_count << " rows"
+              << (analyzed ? "" : ", not analyzed") << "):\n";
+    for (const auto& column : schema) {
+        auto it = column_stats.find(column);
+        if (it != column_stats.end()) {
+            it->second.print(column, stats.row_count);
+        }
+    }
+}
+
+size_t Table::getMemoryUsage() const {
+    const size_t node_overhead = 4 * sizeof(void*);
+    size_t bytes = sizeof(Table) + stringHeapMemory(name) + 
+                   schema.capacity() * sizeof(std::string) + block_ids.capacity() * sizeof(int);
+    for (const auto& column : schema) {
+        bytes += stringHeapMemory(column);
+    }
+    for (const auto& pair : bloom_columns) {
+        bytes += node_overhead + sizeof(pair) + stringHeapMemory(pair.first);
+    }
+    for (const auto& pair : column_stats) {
+        bytes += node_overhead + sizeof(pair.first) + stringHeapMemory(pair.first) + 
+                 pair.second.getMemoryUsage();
+    }
+    return bytes;
+}
+
+void Table::print() const {
+    std::cout << "Table '" << name << "': " << stats.row_count << " rows, "
+              << block_ids.size() << " blocks, " << stats.data_bytes << " bytes";
+    if (stats.deleted_count > 0) {
+        std::cout << ", " << stats.deleted_count << " deleted";
+    }
+    std::cout << "\n  Schema: ";
+    for (size_t i = 0; i < schema.size(); ++i) {
+        std::cout << (i > 0 ? ", " : "") << schema[i];
+    }
+    std::cout << "\n";
+}
+
+void Table::save(SnapshotWriter& out) const {
+    out.putString(name);
+    out.putU32(static_cast<uint32_t>(schema.size()));
+    for (const auto& column : schema) {
+        out.putString(column);
+    }
+    out.putU32(static_cast<uint32_t>(block_ids.size()));
+    for (int block_id : block_ids) {
+        out.putI32(block_id);
+    }
+    out.putI32(insert_block_id);
+    out.putI32(stats.row_count);
+    out.putI32(stats.deleted_count);
+    out.putI64(stats.data_bytes);
+    
+    out.putU32(static_cast<uint32_t>(bloom_columns.size()));
+    for (const auto& pair : bloom_columns) {
+        out.putString(pair.first);
+        out.putDouble(pair.second);
+    }
+    out.putU32(static_cast<uint32_t>(column_stats.size()));
+    for (const auto& pair : column_stats) {
+        out.putString(pair.first);
+        pair.second.save(out);
+    }
+    out.putU8(analyzed ? 1 : 0);
+}
+
+bool Table::load(SnapshotReader& in) {
+    uint32_t count;
+    if (!in.getString(name) || !in.getCount(count, 4)) return false;
+    schema.assign(count, std::string());
+    for (auto& column : schema) {
+        if (!in.getString(column)) return false;
+    }
+    if (!in.getCount(count, 4)) return false;
+    block_ids.assign(count, -1);
+    for (int& block_id : block_ids) {
+        in.getI32(block_id);
+    }
+    if (!in.getI32(insert_block_id) || !in.getI32(stats.row_count) || 
+        !in.getI32(stats.deleted_count) || !in.getI64(stats.data_bytes)) {
+        return false;
+    }
+    
+    bloom_columns.clear();
+    if (!in.getCount(count, 12)) return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string column;
+        if (!in.getString(column) || !in.getDouble(bloom_columns[column])) return false;
+    }
+    column_stats.clear();
+    if (!in.getCount(count, 4)) return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string column;
+        if (!in.getString(column) || !column_stats[column].load(in)) return false;
+    }
+    return in.getBool(analyzed);
+}
+
+// ==================== CATALOG ====================
+Table* Catalog::createTable(const std::string& name, const std::vector<std::string>& schema) {
+    if (tables.count(name)) {
+        return nullptr;
+    }
+    auto result = tables.emplace(name, Table(name, schema));
+    return &result.first->second;
+}
+
+Table* Catalog::getTable(const std::string& name) {
+    auto it = tables.find(name);
+    return (it != tables.end()) ? &it->second : nullptr;
+}
+
+const Table* Catalog::getTable(const std::string& name) const {
+    auto it = tables.find(name);
+    return (it != tables.end()) ? &it->second : nullptr;
+}
+
+bool Catalog::hasTable(const std::string& name) const {
+    return tables.count(name) > 0;
+}
+
+std::vector<std::string> Catalog::getTableNames() const {
+    std::vector<std::string> names;
+    for (const auto& pair : tables) {
+        names.push_back(pair.first);
+    }
+    return names;
+}
+
+int Catalog::getTableCount() const {
+    return static_cast<int>(tables.size());
+}
+
+void Catalog::print() const {
+    std::cout << "\n=== Catalog (" << tables.size() << " tables) ===\n";
+    for (const auto& pair : tables) {
+        pair.second.print();
+    }
+}
+
+void Catalog::save(SnapshotWriter& out) const {
+    out.putU32(static_cast<uint32_t>(tables.size()));
+    for (const auto& pair : tables) {
+        pair.second.save(out);
+    }
+}
+
+bool Catalog::load(SnapshotReader& in) {
+    tables.clear();
+    uint32_t count;
+    if (!in.getCount(count, 4)) return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        Table table;
+        if (!table.load(in)) return false;
+        std::string name = table.name;
+        tables[name] = std::move(table);
+    }
+    return true;
+}
@@ -0,0 +1,612 @@
+#include "compression.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+// ==================== VARINTS ====================
+static void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+static bool getVarint(std::string_view in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < in.length(); shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(in[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+static uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static void putString(std::string& out, const std::string& value) {
+    putVarint(out, value.length());
+    out += value;
+}
+
+static bool getString(std::string_view in, size_t& pos, std::string& value) {
+    uint64_t length;
+    if (!getVarint(in, pos, length) || length > in.length() - pos) return false;
+    value.assign(in, pos, length);
+    pos += length;
+    return true;
+}
+
+// Igual que getString, pero sin copiar: la vista apunta a 'in'
+static bool getStringView(std::string_view in, size_t& pos, std::string_view& value) {
+    uint64_t length;
+    if (!getVarint(in, pos, length) || length > in.length() - pos) return false;
+    value = in.substr(pos, length);
+    pos += length;
+    return true;
+}
+
+// Entero en forma canónica (sin ceros a la izquierda ni signo '+'), de modo
+// que decodificarlo con std::to_string reproduce exactamente el texto
+static bool parseCanonicalInt(const std::string& text, int64_t& value) {
+    if (text.empty() || text.length() > 18) return false;
+    size_t start = (text[0] == '-') ? 1 : 0;
+    if (start == text.length()) return false;
+    if (text[start] == '0' && text.length() > start + 1) return false;
+    if (text == "-0") return false;
+    for (size_t i = start; i < text.length(); ++i) {
+        if (text[i] < '0' || text[i] > '9') return false;
+    }
+    value = std::stoll(text);
+    return true;
+}
+
+// ==================== LZ CODEC ====================
+static const int LZ_MIN_MATCH = 4;
+static const int LZ_HASH_BITS = 12;
+static const size_t LZ_MAX_OFFSET = 65535;
+
+static uint32_t read32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static void putLength(std::string& out, size_t length) {
+    while (length >= 255) {
+        out += static_cast<char>(255);
+        length -= 255;
+    }
+    out += static_cast<char>(length);
+}
+
+static bool getLength(std::string_view in, size_t& pos, size_t& length) {
+    uint8_t byte;
+    do {
+        if (pos >= in.length()) return false;
+        byte = static_cast<uint8_t>(in[pos++]);
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+static void emitSequence(std::string& out, const char* literals, size_t literal_length,
+                         size_t offset, size_t match_length) {
+    uint8_t token = static_cast<uint8_t>(std::min<size_t>(literal_length, 15) << 4);
+    if (match_length > 0) {
+        token |= static_cast<uint8_t>(std::min<size_t>(match_length - LZ_MIN_MATCH, 15));
+    }
+    out += static_cast<char>(token);
+    if (literal_length >= 15) putLength(out, literal_length - 15);
+    out.append(literals, literal_length);
+    
+    if (match_length > 0) {
+        out += static_cast<char>(offset & 0xFF);
+        out += static_cast<char>((offset >> 8) & 0xFF);
+        if (match_length - LZ_MIN_MATCH >= 15) putLength(out, match_length - LZ_MIN_MATCH - 15);
+    }
+}
+
+std::string LZCodec::compress(const std::string& input) {
+    std::string out;
+    out.reserve(input.length() / 2 + 16);
+    const char* data = input.data();
+    size_t length = input.length();
+    
+    std::vector<int64_t> table(static_cast<size_t>(1) << LZ_HASH_BITS, -1);
+    size_t anchor = 0;
+    size_t pos = 0;
+    
+    while (length >= LZ_MIN_MATCH && pos + LZ_MIN_MATCH <= length) {
+        uint32_t sequence = read32(data + pos);
+        uint32_t hash = (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+        int64_t candidate = table[hash];
+        table[hash] = static_cast<int64_t>(pos);
+        
+        if (candidate >= 0 && pos - candidate <= LZ_MAX_OFFSET && 
+            read32(data + candidate) == sequence) {
+            size_t match = LZ_MIN_MATCH;
+            while (pos + match < length && data[candidate + match] == data[pos + match]) {
+                match++;
+            }
+            emitSequence(out, data + anchor, pos - anchor, pos - candidate, match);
+            pos += match;
+            anchor = pos;
+        } else {
+            pos++;
+        }
+    }
+    
+    // Última secuencia: solo literales
+    emitSequence(out, data + anchor, length - anchor, 0, 0);
+    return out;
+}
+
+bool LZCodec::decompress(std::string_view input, size_t original_size, std::string& output) {
+    output.clear();
+    // El tamaño declarado no es de fiar: cada byte de entrada produce como
+    // mucho 255 de salida (un byte de longitud), así que un valor mayor es
+    // un bloque corrupto y no debe llegar a reservarse
+    if (original_size > input.length() * 255 + LZ_MIN_MATCH + 15) return false;
+    output.reserve(original_size);
+    size_t pos = 0;
+    
+    while (pos < input.length()) {
+        uint8_t token = static_cast<uint8_t>(input[pos++]);
+        
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !getLength(input, pos, literal_length)) return false;
+        if (pos + literal_length > input.length()) return false;
+        if (output.length() + literal_length > original_size) return false;
+        output.append(input, pos, literal_length);
+        pos += literal_length;
+        
+        if (pos == input.length()) break;  // Secuencia final sin coincidencia
+        
+        if (pos + 2 > input.length()) return false;
+        size_t offset = static_cast<uint8_t>(input[pos]) | 
+                        (static_cast<size_t>(static_cast<uint8_t>(input[pos + 1])) << 8);
+        pos += 2;
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 && !getLength(input, pos, match_length)) return false;
+        match_length += LZ_MIN_MATCH;
+        
+        if (offset == 0 || offset > output.length()) return false;
+        if (output.length() + match_length > original_size) return false;
+        // Copia byte a byte: la coincidencia puede solaparse con su propio origen
+        size_t from = output.length() - offset;
+        for (size_t i = 0; i < match_length; ++i) {
+            output += output[from + i];
+        }
+    }
+    return output.length() == original_size;
+}
+
+// ==================== BLOCK CODEC ====================
+static void setBit(std::string& bitmap, size_t index) {
+    bitmap[index / 8] = static_cast<char>(bitmap[index / 8] | (1 << (index % 8)));
+}
+
+static bool getBit(std::string_view bitmap, size_t offset, size_t index) {
+    return (static_cast<uint8_t>(bitmap[offset + index / 8]) >> (index % 8)) & 1;
+}
+
+static void encodeColumn(std::string& out, const std::string& name,
+                         const std::vector<Record>& records) {
+    size_t n = records.size();
+    std::string presence((n + 7) / 8, '\0');
+    std::vector<const std::string*> values;
+    values.reserve(n);
+    
+    for (size_t i = 0; i < n; ++i) {
+        auto it = records[i].data.find(name);
+        if (it != records[i].data.end()) {
+            setBit(presence, i);
+            values.push_back(&it->second);
+        }
+    }
+    
+    putString(out, name);
+    out += presence;
+    
+    // Enteros canónicos: frame of reference sobre el mínimo del bloque
+    bool all_integers = !values.empty();
+    std::vector<int64_t> integers;
+    integers.reserve(values.size());
+    for (const std::string* value : values) {
+        int64_t number;
+        if (!parseCanonicalInt(*value, number)) {
+            all_integers = false;
+            break;
+        }
+        integers.push_back(number);
+    }
+    if (all_integers) {
+        int64_t base = *std::min_element(integers.begin(), integers.end());
+        out += static_cast<char>(ColumnEncoding::FRAME_OF_REFERENCE);
+        putVarint(out, zigzag(base));
+        for (int64_t number : integers) {
+            putVarint(out, static_cast<uint64_t>(number - base));
+        }
+        return;
+    }
+    
+    // Baja cardinalidad: diccionario con códigos de 1 byte
+    std::map<std::string, int> dictionary;
+    for (const std::string* value : values) {
+        dictionary.emplace(*value, 0);
+        if (dictionary.size() > 255) break;
+    }
+    if (dictionary.size() <= 255 && dictionary.size() * 2 <= values.size()) {
+        out += static_cast<char>(ColumnEncoding::DICTIONARY);
+        putVarint(out, dictionary.size());
+        int code = 0;
+        for (auto& entry : dictionary) {
+            entry.second = code++;
+            putString(out, entry.first);
+        }
+        for (const std::string* value : values) {
+            out += static_cast<char>(dictionary[*value]);
+        }
+        return;
+    }
+    
+    out += static_cast<char>(ColumnEncoding::PLAIN);
+    for (const std::string* value : values) {
+        putString(out, *value);
+    }
+}
+
+static bool decodeColumn(const std::string& in, size_t& pos, std::vector<Record>& records) {
+    size_t n = records.size();
+    std::string name;
+    if (!getString(in, pos, name)) return false;
+    
+    size_t bitmap_offset = pos;
+    pos += (n + 7) / 8;
+    if (pos + 1 > in.length()) return false;
+    ColumnEncoding encoding = static_cast<ColumnEncoding>(in[pos++]);
+    
+    std::vector<std::string> dictionary;
+    int64_t base = 0;
+    if (encoding == ColumnEncoding::DICTIONARY) {
+        uint64_t size;
+        if (!getVarint(in, pos, size) || size > 256) return false;
+        dictionary.resize(size);
+        for (auto& entry : dictionary) {
+            if (!getString(in, pos, entry)) return false;
+        }
+    } else if (encoding == ColumnEncoding::FRAME_OF_REFERENCE) {
+        uint64_t encoded_base;
+        if (!getVarint(in, pos, encoded_base)) return false;
+        base = unzigzag(encoded_base);
+    } else if (encoding != ColumnEncoding::PLAIN) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < n; ++i) {
+        if (!getBit(in, bitmap_offset, i)) continue;
+        std::string& target = records[i].data[name];
+        
+        switch (encoding) {
+            case ColumnEncoding::PLAIN:
+                if (!getString(in, pos, target)) return false;
+                break;
+            case ColumnEncoding::DICTIONARY: {
+                if (pos >= in.length()) return false;
+                size_t code = static_cast<uint8_t>(in[pos++]);
+                if (code >= dictionary.size()) return false;
+                target = dictionary[code];
+                break;
+            }
+            case ColumnEncoding::FRAME_OF_REFERENCE: {
+                uint64_t delta;
+                if (!getVarint(in, pos, delta)) return false;
+                target = std::to_string(base + static_cast<int64_t>(delta));
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+std::string BlockCodec::encode(const std::vector<Record>& records) {
+    std::string body;
+    size_t n = records.size();
+    putVarint(body, n);
+    
+    // IDs de registro en delta (normalmente crecientes dentro del bloque)
+    int64_t previous = 0;
+    for (const auto& record : records) {
+        putVarint(body, zigzag(static_cast<int64_t>(record.record_id) - previous));
+        previous = record.record_id;
+    }
+    
+    std::string deleted((n + 7) / 8, '\0');
+    for (size_t i = 0; i < n; ++i) {
+        if (records[i].is_deleted) setBit(deleted, i);
+    }
+    body += deleted;
+    
+    // Unión de las columnas presentes en el bloque
+    std::map<std::string, int> columns;
+    for (const auto& record : records) {
+        for (const auto& pair : record.data) {
+            columns.emplace(pair.first, 0);
+        }
+    }
+    putVarint(body, columns.size());
+    for (const auto& column : columns) {
+        encodeColumn(body, column.first, records);
+    }
+    
+    std::string out = "BK";
+    out += static_cast<char>(FORMAT_VERSION);
+    
+    // El compresor genérico solo se aplica si reduce el tamaño
+    std::string compressed = LZCodec::compress(body);
+    if (compressed.length() + 4 < body.length()) {
+        out += static_cast<char>(FLAG_LZ);
+        putVarint(out, body.length());
+        out += compressed;
+    } else {
+        out += static_cast<char>(0);
+        out += body;
+    }
+    return out;
+}
+
+bool BlockCodec::isEncoded(std::string_view data) {
+    return data.length() >= 4 && data[0] == 'B' && data[1] == 'K' && 
+           static_cast<uint8_t>(data[2]) == FORMAT_VERSION;
+}
+
+bool BlockCodec::decode(const std::string& data, std::vector<Record>& records) {
+    records.clear();
+    
+    if (!isEncoded(data)) {
+        // Formato de texto heredado
+        std::istringstream iss(data);
+        std::string line;
+        while (std::getline(iss, line)) {
+            if (!line.empty()) {
+                records.push_back(Record::deserialize(line));
+            }
+        }
+        return true;
+    }
+    
+    uint8_t flags = static_cast<uint8_t>(data[3]);
+    size_t pos = 4;
+    std::string decompressed;
+    const std::string* body = &data;
+    if (flags & FLAG_LZ) {
+        uint64_t body_length;
+        if (!getVarint(data, pos, body_length)) return false;
+        if (!LZCodec::decompress(std::string_view(data).substr(pos), body_length, decompressed)) return false;
+        body = &decompressed;
+        pos = 0;
+    }
+    const std::string& in = *body;
+    
+    // Cada registro ocupa al menos un byte (su ID): un recuento mayor que lo
+    // que queda de entrada es corrupto y no se reserva
+    uint64_t n;
+    if (!getVarint(in, pos, n) || n > in.length() - pos) return false;
+    records.resize(n);
+    
+    int64_t previous = 0;
+    for (auto& record : records) {
+        uint64_t delta;
+        if (!getVarint(in, pos, delta)) return false;
+        previous += unzigzag(delta);
+        record.record_id = static_cast<int>(previous);
+    }
+    
+    size_t deleted_offset = pos;
+    pos += (n + 7) / 8;
+    if (pos > in.length()) return false;
+    for (size_t i = 0; i < n; ++i) {
+        records[i].is_deleted = getBit(in, deleted_offset, i);
+    }
+    
+    uint64_t num_columns;
+    if (!getVarint(in, pos, num_columns)) return false;
+    for (uint64_t c = 0; c < num_columns; ++c) {
+        if (!decodeColumn(in, pos, records)) return false;
+    }
+    return true;
+}
+
+// ==================== ENCODED BLOCK ====================
+EncodedBlock::EncodedBlock() : row_count(0), deleted_offset(0), column_count(0) {}
+
+bool EncodedBlock::open(std::string_view data) {
+    row_count = 0;
+    column_count = 0;
+    if (!BlockCodec::isEncoded(data)) return false;
+    
+    uint8_t flags = static_cast<uint8_t>(data[3]);
+    size_t pos = 4;
+    body = data;
+    if (flags & BlockCodec::FLAG_LZ) {
+        uint64_t body_length;
+        if (!getVarint(data, pos, body_length)) return false;
+        if (!LZCodec::decompress(data.substr(pos), body_length, decompressed)) return false;
+        body = decompressed;
+        pos = 0;
+    }
+    
+    uint64_t n;
+    if (!getVarint(body, pos, n) || n > body.length()) return false;
+    row_count = n;
+    record_ids.resize(n);
+    int64_t previous = 0;
+    for (auto& record_id : record_ids) {
+        uint64_t delta;
+        if (!getVarint(body, pos, delta)) return false;
+        previous += unzigzag(delta);
+        record_id = static_cast<int>(previous);
+    }
+    
+    deleted_offset = pos;
+    pos += (n + 7) / 8;
+    if (pos > body.length()) return false;
+    
+    uint64_t num_columns;
+    if (!getVarint(body, pos, num_columns) || num_columns > body.length()) return false;
+    if (columns.size() < num_columns) {
+        columns.resize(num_columns);
+    }
+    
+    // Cabecera de cada columna; sus valores solo se saltan
+    for (uint64_t c = 0; c < num_columns; ++c) {
+        Column& column = columns[c];
+        if (!getStringView(body, pos, column.name)) return false;
+        column.bitmap_offset = pos;
+        pos += (n + 7) / 8;
+        if (pos + 1 > body.length()) return false;
+        column.encoding = static_cast<ColumnEncoding>(body[pos++]);
+        column.base = 0;
+        column.dictionary.clear();
+        
+        if (column.encoding == ColumnEncoding::DICTIONARY) {
+            uint64_t size;
+            if (!getVarint(body, pos, size) || size > 256) return false;
+            column.dictionary.resize(size);
+            for (auto& entry : column.dictionary) {
+                if (!getStringView(body, pos, entry)) return false;
+            }
+        } else if (column.encoding == ColumnEncoding::FRAME_OF_REFERENCE) {
+            uint64_t encoded_base;
+            if (!getVarint(body, pos, encoded_base)) return false;
+            column.base = unzigzag(encoded_base);
+        } else if (column.encoding != ColumnEncoding::PLAIN) {
+            return false;
+        }
+        
+        column.values_offset = pos;
+        column.located = false;
+        if (!walkValues(column, pos, nullptr)) return false;
+    }
+    
+    column_count = num_columns;
+    return true;
+}
+
+bool EncodedBlock::walkValues(const Column& column, size_t& pos, 
+                              std::vector<uint32_t>* offsets) const {
+    if (offsets != nullptr) {
+        offsets->assign(row_count, NO_VALUE);
+    }
+    for (size_t i = 0; i < row_count; ++i) {
+        if (!getBit(body, column.bitmap_offset, i)) continue;
+        if (offsets != nullptr) {
+            (*offsets)[i] = static_cast<uint32_t>(pos);
+        }
+        
+        switch (column.encoding) {
+            case ColumnEncoding::PLAIN: {
+                std::string_view skipped;
+                if (!getStringView(body, pos, skipped)) return false;
+                break;
+            }
+            case ColumnEncoding::DICTIONARY:
+                if (pos >= body.length() || 
+                    static_cast<uint8_t>(body[pos]) >= column.dictionary.size()) return false;
+                pos++;
+                break;
+            case ColumnEncoding::FRAME_OF_REFERENCE: {
+                uint64_t delta;
+                if (!getVarint(body, pos, delta)) return false;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool EncodedBlock::locate(Column& column) const {
+    size_t pos = column.values_offset;
+    column.located = walkValues(column, pos, &column.offsets);
+    return column.located;
+}
+
+size_t EncodedBlock::getRowCount() const {
+    return row_count;
+}
+
+int EncodedBlock::getRecordId(size_t row) const {
+    return record_ids[row];
+}
+
+bool EncodedBlock::isDeleted(size_t row) const {
+    return getBit(body, deleted_offset, row);
+}
+
+long EncodedBlock::findRow(int record_id) const {
+    for (size_t row = 0; row < row_count; ++row) {
+        if (record_ids[row] == record_id) {
+            return static_cast<long>(row);
+        }
+    }
+    return -1;
+}
+
+size_t EncodedBlock::getColumnCount() const {
+    return column_count;
+}
+
+std::string_view EncodedBlock::getColumnName(size_t column) const {
+    return columns[column].name;
+}
+
+int EncodedBlock::findColumn(const std::string& name) const {
+    for (size_t c = 0; c < column_count; ++c) {
+        if (columns[c].name == name) {
+            return static_cast<int>(c);
+        }
+    }
+    return -1;
+}
+
+bool EncodedBlock::getValue(size_t column_index, size_t row, std::string_view& value) const {
+    if (column_index >= column_count || row >= row_count) return false;
+    Column& column = columns[column_index];
+    if (!getBit(body, column.bitmap_offset, row)) return false;
+    if (!column.located && !locate(column)) return false;
+    
+    size_t pos = column.offsets[row];
+    switch (column.encoding) {
+        case ColumnEncoding::PLAIN:
+            return getStringView(body, pos, value);
+        case ColumnEncoding::DICTIONARY:
+            value = column.dictionary[static_cast<uint8_t>(body[pos])];
+            return true;
+        case ColumnEncoding::FRAME_OF_REFERENCE: {
+            uint64_t delta;
+            if (!getVarint(body, pos, delta)) return false;
+            // Mismo texto que std::to_string en BlockCodec::decode
+            char* end = std::to_chars(column.integer_text, 
+                                      column.integer_text + INTEGER_TEXT_BYTES,
+                                      column.base + static_cast<int64_t>(delta)).ptr;
+            value = std::string_view(column.integer_text, end - column.integer_text);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t EncodedBlock::getColumnsAccessed() const {
+    size_t accessed = 0;
+    for (size_t c = 0; c < column_count; ++c) {
+        if (columns[c].located) accessed++;
+    }
+    return accessed;
+}
@@ -1,18 +1,50 @@
 #include "disk_manager.h"
 
 // ==================== BLOCK ====================
-Block::Block(int id, int max_rec) 
-    : block_id(id), max_records(max_rec), is_dirty(false) {}
+Block::Block(int id, int capacity, double fill) 
+    : block_id(id), capacity_bytes(capacity), used_bytes(0), 
+      fill_factor(fill), is_dirty(false), is_loaded(true), pin_count(0),
+      record_heap_bytes(0), stored_bytes(0) {}
 
-bool Block::hasSpace() const {
-    return records.size() < max_records;
+int Block::getFreeSpace() const {
+    return static_cast<int>(capacity_bytes * fill_factor) - used_bytes;
+}
+
+bool Block::hasSpace(int required_bytes) const {
+    return required_bytes <= getFreeSpace();
+}
+
+int Block::encodedSize(const Record& record) {
+    // Registro serializado más el separador de línea
+    return record.getSize() + 1;
 }
 
 bool Block::addRecord(const Record& record) {
-    if (!hasSpace()) {
+    int size = encodedSize(record);
+    if (!hasSpace(size)) {
         return false;
     }
     records.push_back(record);
+    used_bytes += size;
+    record_heap_bytes += record.getHeapMemory();
+    zone_map.add(record);
+    for (auto& pair : bloom_filters) {
+        auto it = record.data.find(pair.first);
+        if (it != record.data.end()) {
+            pair.second.add(it->second);
+        }
+        if (pair.second.isOverloaded()) {
+            // Más valores de los previstos: duplicar el filtro para mantener el FPR
+            pair.second = BloomFilter(pair.second.getExpectedKeys() * 2, 
+                                      pair.second.getTargetFpr());
+            for (const auto& stored : records) {
+                auto value = stored.data.find(pair.first);
+                if (value != stored.data.end()) {
+                    pair.second.add(value->second);
+                }
+            }
+        }
+    }
     is_dirty = true;
     return true;
 }
@@ -22,6 +54,47 @@ bool Block::removeRecord(int record_id) {
         if (record.record_id == record_id) {
             record.is_deleted = true;
             is_dirty = true;
+            // El rango puede haberse estrechado: recalcular el zone map.
+            // Los filtros de Bloom conservan el valor (solo falsos positivos).
+            zone_map.rebuild(records);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Block::updateRecord(const Record& updated) {
+    for (auto& record : records) {
+        if (record.record_id != updated.record_id || record.is_deleted) continue;
+        
+        int new_used = used_bytes - encodedSize(record) + encodedSize(updated);
+        if (new_used > capacity_bytes) {
+            return false;
+        }
+        record_heap_bytes += updated.getHeapMemory() - record.getHeapMemory();
+        record = updated;
+        used_bytes = new_used;
+        zone_map.rebuild(records);
+        for (auto& pair : bloom_filters) {
+            auto it = updated.data.find(pair.first);
+            if (it != updated.data.end()) {
+                pair.second.add(it->second);
+            }
+        }
+        is_dirty = true;
+        return true;
+    }
+    return false;
+}
+
+bool Block::extractRecord(int record_id) {
+    for (auto it = records.begin(); it != records.end(); ++it) {
+        if (it->record_id == record_id && !it->is_deleted) {
+            used_bytes -= encodedSize(*it);
+            record_heap_bytes -= it->getHeapMemory();
+            records.erase(it);
+            zone_map.rebuild(records);
+            is_dirty = true;
             return true;
         }
     }
@@ -42,39 +115,214 @@ std::vector<Record*> Block::findRecordsByAttribute(const std::string& attribute,
                                            const std::string& operator_type) {
     std::vector<Record*> results;
     
+    // El operador se resuelve una sola vez, no por cada registro
+    CompareOp op;
+    if (!parseCompareOp(operator_type, op)) {
+        return results;
+    }
+    Comparison comparison(attribute, op, value);
+    
     for (auto& record : records) {
-        if (record.is_deleted) continue;
-        
-        if (record.data.find(attribute) != record.data.end()) {
-            std::string record_value = record.data.at(attribute);
-            bool matches = false;
-            
-            if (operator_type == "=") {
-                matches = (record_value == value);
-            } else if (operator_type == ">=") {
-                matches = (record_value >= value);
-            } else if (operator_type == "<=") {
-                matches = (record_value <= value);
-            } else if (operator_type == ">") {
-                matches = (record_value > value);
-            } else if (operator_type == "<") {
-                matches = (record_value < value);
+        if (!record.is_deleted && comparison.matches(record)) {
+            results.push_back(&record);
+        }
+    }
+    
+    return results;
+}
+
+std::vector<Record*> Block::findRecords(const Predicate& predicate) {
+    std::vector<Record*> results;
+    
+    for (auto& record : records) {
+        if (!record.is_deleted && predicate.evaluate(record)) {
+            results.push_back(&record);
+        }
+    }
+    
+    return results;
+}
+
+bool Block::mayMatch(const Predicate& predicate) const {
+    return zone_map.mayMatch(predicate);
+}
+
+void Block::enableBloomFilter(const std::string& column, double fpr) {
+    // Tamaño inicial estimado para registros de ~64 bytes; crece si se queda corto
+    int expected = std::max(static_cast<int>(records.size()), 
+                            std::max(8, capacity_bytes / 64));
+    BloomFilter filter(expected, fpr);
+    for (const auto& record : records) {
+        auto it = record.data.find(column);
+        if (it != record.data.end()) {
+            filter.add(it->second);
+        }
+    }
+    bloom_filters[column] = filter;
+}
+
+void Block::rebuildBloomFilters() {
+    for (auto& pair : bloom_filters) {
+        enableBloomFilter(pair.first, pair.second.getTargetFpr());
+    }
+}
+
+bool Block::bloomMayMatchNode(const Predicate::Node& node, bool& consulted) const {
+    switch (node.kind) {
+        case Predicate::Kind::TRUE_CONST:
+            return true;
+        case Predicate::Kind::COMPARISON: {
+            if (node.comparison.op != CompareOp::EQ) return true;
+            auto it = bloom_filters.find(node.comparison.attribute);
+            if (it == bloom_filters.end()) return true;
+            consulted = true;
+            return it->second.mayContain(node.comparison);
+        }
+        case Predicate::Kind::AND:
+            for (const auto& child : node.children) {
+                if (!bloomMayMatchNode(child, consulted)) return false;
             }
-            
-            if (matches) {
-                results.push_back(&record);
+            return true;
+        case Predicate::Kind::OR:
+            for (const auto& child : node.children) {
+                if (bloomMayMatchNode(child, consulted)) return true;
             }
+            return false;
+    }
+    return true;
+}
+
+bool Block::bloomMayMatch(const Predicate& predicate, bool& consulted) const {
+    consulted = false;
+    if (bloom_filters.empty()) return true;
+    return bloomMayMatchNode(predicate.getRoot(), consulted);
+}
+
+std::string Block::serialize() const {
+    return BlockCodec::encode(records);
+}
+
+bool Block::deserialize(const std::string& block_data) {
+    if (!BlockCodec::decode(block_data, records)) {
+        // used_bytes se conserva: con 0, placeRecord vería el bloque
+        // ilegible como vacío y lo elegiría para insertar
+        records.clear();
+        record_heap_bytes = 0;
+        zone_map.clear();
+        return false;
+    }
+    zone_map.rebuild(records);
+    rebuildBloomFilters();
+    is_loaded = true;
+    
+    // El fill factor se aplica sobre el tamaño lógico (sin comprimir)
+    used_bytes = 0;
+    record_heap_bytes = 0;
+    for (const auto& record : records) {
+        used_bytes += encodedSize(record);
+        record_heap_bytes += record.getHeapMemory();
+    }
+    return true;
+}
+
+void Block::unload() {
+    // used_bytes se conserva: el espacio lógico del bloque no cambia
+    std::vector<Record>().swap(records);
+    record_heap_bytes = 0;
+    is_loaded = false;
+}
+
+size_t Block::getMemoryUsage() const {
+    return records.capacity() * sizeof(Record) + record_heap_bytes;
+}
+
+size_t Block::getMetadataMemory() const {
+    size_t bytes = sizeof(Block) + stringHeapMemory(table_name) + 
+                   extents.capacity() * sizeof(Extent) + zone_map.getMemoryUsage();
+    for (const auto& pair : bloom_filters) {
+        bytes += 4 * sizeof(void*) + sizeof(pair) + stringHeapMemory(pair.first) + 
+                 pair.second.getMemoryBytes();
+    }
+    return bytes;
+}
+
+void Block::saveMetadata(SnapshotWriter& out) const {
+    out.putI32(block_id);
+    out.putString(table_name);
+    out.putI32(capacity_bytes);
+    out.putI32(used_bytes);
+    out.putDouble(fill_factor);
+    out.putI32(location.platter_id);
+    out.putI32(location.surface_id);
+    out.putI32(location.track_id);
+    out.putI32(location.sector_id);
+    out.putI32(location.position);
+    out.putU32(static_cast<uint32_t>(extents.size()));
+    for (const auto& extent : extents) {
+        out.putI32(extent.platter_id);
+        out.putI32(extent.surface_id);
+        out.putI32(extent.track_id);
+        out.putI32(extent.start_sector);
+        out.putI32(extent.sector_count);
+    }
+    out.putU64(stored_bytes);
+    zone_map.save(out);
+    out.putU32(static_cast<uint32_t>(bloom_filters.size()));
+    for (const auto& pair : bloom_filters) {
+        out.putString(pair.first);
+        pair.second.save(out);
+    }
+}
+
+bool Block::loadMetadata(SnapshotReader& in, const DiskManager& disk) {
+    uint32_t count;
+    uint64_t stored;
+    if (!in.getI32(block_id) || !in.getString(table_name) || !in.getI32(capacity_bytes) ||
+        !in.getI32(used_bytes) || !in.getDouble(fill_factor) ||
+        !in.getI32(location.platter_id) || !in.getI32(location.surface_id) ||
+        !in.getI32(location.track_id) || !in.getI32(location.sector_id) ||
+        !in.getI32(location.position) || !in.getCount(count, 20)) {
+        return false;
+    }
+    // El checksum solo detecta corrupción accidental: un extent fuera de la
+    // geometría se indexaría directamente en las pistas al cargar el bloque
+    extents.assign(count, Extent());
+    for (auto& extent : extents) {
+        if (!in.getI32(extent.platter_id) || !in.getI32(extent.surface_id) ||
+            !in.getI32(extent.track_id) || !in.getI32(extent.start_sector) ||
+            !in.getI32(extent.sector_count) || !disk.isValidExtent(extent)) {
+            return false;
         }
     }
+    if (!in.getU64(stored) || !zone_map.load(in) || !in.getCount(count, 28)) {
+        return false;
+    }
+    stored_bytes = static_cast<size_t>(stored);
+    bloom_filters.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string column;
+        if (!in.getString(column) || !bloom_filters[column].load(in)) return false;
+    }
     
-    return results;
+    std::vector<Record>().swap(records);
+    record_heap_bytes = 0;
+    is_loaded = false;
+    is_dirty = false;
+    pin_count = 0;
+    return true;
 }
 
 void Block::print() const {
     std::cout << "\n=== Block " << block_id << " ===\n";
     std::cout << "Location: ";
     location.print();
-    std::cout << "Records: " << records.size() << "/" << max_records << "\n";
+    std::cout << "Extents: " << extents.size() << "\n";
+    for (const auto& extent : extents) {
+        std::cout << "  ";
+        extent.print();
+    }
+    std::cout << "Records: " << records.size() << " (" << used_bytes << "/" 
+              << capacity_bytes << " bytes, fill factor " << fill_factor << ")\n";
     std::cout << "Dirty: " << (is_dirty ? "Yes" : "No") << "\n";
     
     for (const auto& record : records) {
@@ -86,87 +334,385 @@ void Block::print() const {
 }
 
 // ==================== BUFFER MANAGER ====================
-BufferManager::BufferManager(int max_size) : max_buffer_size(max_size) {}
+BufferManager::BufferManager(size_t max_bytes) 
+    : max_buffer_bytes(max_bytes), used_bytes(0), disk_manager(nullptr), output(&std::cout),
+      hits(0), loads(0), evictions(0), evicted_bytes(0), dirty_evictions(0), background_writes(0),
+      checkpoint_active(false), checkpoint_blocks(0), checkpoints_completed(0),
+      last_checkpoint_ms(0), last_checkpoint_blocks(0), wakeup_bytes(0) {}
 
 BufferManager::~BufferManager() {
-    // Escribir todos los bloques sucios antes de destruir
+    // Escribir todos los bloques sucios antes de destruir.
+    // Los bloques pertenecen al SGBD; el buffer solo los referencia.
     flushAllBlocks();
-    
-    // Liberar memoria
-    for (auto& pair : buffer_pool) {
-        delete pair.second;
-    }
+}
+
+void BufferManager::attachDisk(DiskManager* disk) {
+    disk_manager = disk;
+}
+
+void BufferManager::setOutput(std::ostream& stream) {
+    output = &stream;
+}
+
+void BufferManager::touch(Frame& frame) {
+    lru_list.splice(lru_list.begin(), lru_list, frame.lru_position);
 }
 
 Block* BufferManager::getBlock(int block_id) {
     auto it = buffer_pool.find(block_id);
     if (it != buffer_pool.end()) {
-        return it->second;
+        touch(it->second);
+        return it->second.block;
     }
     return nullptr;
 }
 
 bool BufferManager::addBlock(Block* block) {
-    if (buffer_pool.size() >= max_buffer_size) {
-        // Implementar política LRU - remover el bloque menos usado
-        evictLRU();
+    if (buffer_pool.count(block->block_id)) {
+        updateUsage(block);
+        return true;
     }
+    lru_list.push_front(block->block_id);
+    Frame frame;
+    frame.block = block;
+    frame.charged_bytes = block->getMemoryUsage();
+    frame.lru_position = lru_list.begin();
+    buffer_pool[block->block_id] = frame;
+    used_bytes += frame.charged_bytes;
     
-    buffer_pool[block->block_id] = block;
-    lru_queue.push(block->block_id);
+    enforceBudget(block);
     return true;
 }
 
-void BufferManager::evictLRU() {
-    if (lru_queue.empty()) return;
+Block* BufferManager::fetchBlock(Block* block) {
+    auto it = buffer_pool.find(block->block_id);
+    if (it != buffer_pool.end()) {
+        hits++;
+        touch(it->second);
+        return block;
+    }
     
-    int block_to_evict = lru_queue.front();
-    lru_queue.pop();
+    if (!block->is_loaded) {
+        // Bloque descargado: leer sus registros desde el disco
+        if (disk_manager == nullptr || !disk_manager->loadBlock(block)) {
+            return nullptr;
+        }
+        loads++;
+    }
+    addBlock(block);
+    return block;
+}
+
+Block* BufferManager::pinBlock(Block* block) {
+    if (fetchBlock(block) == nullptr) {
+        return nullptr;
+    }
+    block->pin_count++;
+    return block;
+}
+
+void BufferManager::unpinBlock(Block* block) {
+    if (block->pin_count > 0) {
+        block->pin_count--;
+    }
+    // Los bloques que se cargaron estando otros fijados pudieron dejar el
+    // buffer por encima del presupuesto: al soltar el último pin ya se
+    // puede desalojar
+    if (block->pin_count == 0) {
+        enforceBudget(nullptr);
+    }
+}
+
+// ==================== BLOCK PIN ====================
+BlockPin::BlockPin(BufferManager& buffer_manager, Block* target)
+    : buffer(buffer_manager), block(buffer_manager.pinBlock(target)) {}
+
+BlockPin::~BlockPin() {
+    release();
+}
+
+Block* BlockPin::get() const {
+    return block;
+}
+
+void BlockPin::release() {
+    if (block != nullptr) {
+        buffer.unpinBlock(block);
+        block = nullptr;
+    }
+}
+
+void BufferManager::updateUsage(Block* block) {
+    auto it = buffer_pool.find(block->block_id);
+    if (it == buffer_pool.end()) return;
     
-    auto it = buffer_pool.find(block_to_evict);
-    if (it != buffer_pool.end()) {
-        Block* block = it->second;
-        if (block->is_dirty) {
-            // Escribir el bloque al disco antes de eliminarlo
-            writeBlockToDisk(block);
+    size_t charged = block->getMemoryUsage();
+    used_bytes = used_bytes - it->second.charged_bytes + charged;
+    it->second.charged_bytes = charged;
+    touch(it->second);
+    enforceBudget(block);
+}
+
+bool BufferManager::evictBlock(int block_id) {
+    auto it = buffer_pool.find(block_id);
+    if (it == buffer_pool.end()) return false;
+    
+    Block* block = it->second.block;
+    // Sin extensiones no hay copia en disco desde la que recargarlo
+    if (block->pin_count > 0 || block->extents.empty()) {
+        return false;
+    }
+    if (block->is_dirty) {
+        // Escribir el bloque al disco antes de sacarlo del buffer. Con el
+        // escritor en segundo plano activo esto debería ser poco frecuente.
+        writeBlockToDisk(block);
+        if (block->is_dirty) return false;
+        dirty_evictions++;
+        if (writer_wakeup) {
+            writer_wakeup();
         }
-        delete block;
-        buffer_pool.erase(it);
+    }
+    
+    evicted_bytes += static_cast<long long>(it->second.charged_bytes);
+    used_bytes -= it->second.charged_bytes;
+    lru_list.erase(it->second.lru_position);
+    buffer_pool.erase(it);
+    block->unload();
+    evictions++;
+    return true;
+}
+
+void BufferManager::enforceBudget(const Block* keep) {
+    // Recorrer desde el menos usado; los bloques con pins se saltan
+    auto position = lru_list.end();
+    while (used_bytes > max_buffer_bytes && position != lru_list.begin()) {
+        --position;
+        int block_id = *position;
+        if (keep != nullptr && block_id == keep->block_id) continue;
+        
+        auto next = position;
+        ++next;
+        if (evictBlock(block_id)) {
+            position = next;
+        }
+    }
+    
+    // Los próximos desalojos escribirían en primer plano: adelantar la
+    // siguiente ronda del escritor en vez de esperar a su periodo
+    if (writer_wakeup && used_bytes >= wakeup_bytes && !lru_list.empty() &&
+        buffer_pool.at(lru_list.back()).block->is_dirty) {
+        writer_wakeup();
+    }
+}
+
+void BufferManager::evictLRU() {
+    for (auto it = lru_list.rbegin(); it != lru_list.rend(); ++it) {
+        if (evictBlock(*it)) return;
     }
 }
 
 void BufferManager::flushAllBlocks() {
     for (auto& pair : buffer_pool) {
-        if (pair.second->is_dirty) {
-            writeBlockToDisk(pair.second);
+        if (pair.second.block->is_dirty) {
+            writeBlockToDisk(pair.second.block);
         }
     }
 }
 
-void BufferManager::writeBlockToDisk(Block* block) {
-    // Simulación de escritura al disco
-    std::cout << "Writing Block " << block->block_id << " to disk at location: ";
-    block->location.print();
+void BufferManager::clear() {
+    buffer_pool.clear();
+    lru_list.clear();
+    used_bytes = 0;
+    checkpoint_pending.clear();
+    checkpoint_active = false;
+}
+
+void BufferManager::writeBlockToDisk(Block* block, bool log) {
+    if (log) {
+        *output << "Writing Block " << block->block_id << " to disk at location: ";
+        block->location.print(*output);
+    }
+    if (disk_manager != nullptr && !block->extents.empty()) {
+        if (!disk_manager->writeBlock(block)) {
+            return;  // Se mantiene sucio para un reintento posterior
+        }
+    }
     block->is_dirty = false;
+    
+    if (checkpoint_active && checkpoint_pending.erase(block->block_id) > 0 &&
+        checkpoint_pending.empty()) {
+        finishCheckpoint();
+    }
+}
+
+size_t BufferManager::writeCheckpointBlock() {
+    while (checkpoint_active && !checkpoint_pending.empty()) {
+        int block_id = *checkpoint_pending.begin();
+        auto it = buffer_pool.find(block_id);
+        if (it == buffer_pool.end() || !it->second.block->is_dirty) {
+            // Ya se escribió (o se desalojó) por otro camino
+            checkpoint_pending.erase(block_id);
+            continue;
+        }
+        
+        Block* block = it->second.block;
+        writeBlockToDisk(block, false);
+        if (block->is_dirty) {
+            // Sin espacio para escribirlo: no bloquear el checkpoint por él
+            checkpoint_pending.erase(block_id);
+            continue;
+        }
+        background_writes++;
+        return std::max<size_t>(block->stored_bytes, 1);
+    }
+    
+    if (checkpoint_active) {
+        finishCheckpoint();
+    }
+    return 0;
+}
+
+size_t BufferManager::cleanLRUTail(int scan_depth, size_t scan_bytes) {
+    // Limpiar los bloques más cercanos a ser desalojados, de modo que el
+    // desalojo encuentre víctimas limpias y no escriba en primer plano
+    int scanned = 0;
+    size_t covered = 0;
+    for (auto it = lru_list.rbegin(); 
+         it != lru_list.rend() && (scanned < scan_depth || covered < scan_bytes); 
+         ++it, ++scanned) {
+        const Frame& frame = buffer_pool.at(*it);
+        Block* block = frame.block;
+        covered += frame.charged_bytes;
+        if (!block->is_dirty || block->extents.empty()) continue;
+        
+        writeBlockToDisk(block, false);
+        if (block->is_dirty) continue;
+        background_writes++;
+        return std::max<size_t>(block->stored_bytes, 1);
+    }
+    return 0;
+}
+
+void BufferManager::setWriterWakeup(std::function<void()> wakeup, size_t fill_bytes) {
+    writer_wakeup = std::move(wakeup);
+    wakeup_bytes = fill_bytes;
+}
+
+void BufferManager::finishCheckpoint() {
+    checkpoint_active = false;
+    checkpoints_completed++;
+    last_checkpoint_ms = checkpoint_timer.getElapsedTime();
+    last_checkpoint_blocks = checkpoint_blocks;
+}
+
+void BufferManager::beginCheckpoint() {
+    checkpoint_pending.clear();
+    for (const auto& pair : buffer_pool) {
+        const Block* block = pair.second.block;
+        if (block->is_dirty && !block->extents.empty()) {
+            checkpoint_pending.insert(pair.first);
+        }
+    }
+    // Sin bloques sucios no hay nada que acotar
+    checkpoint_blocks = static_cast<int>(checkpoint_pending.size());
+    checkpoint_timer.start();
+    checkpoint_active = checkpoint_blocks > 0;
+}
+
+bool BufferManager::isCheckpointActive() const {
+    return checkpoint_active;
+}
+
+int BufferManager::getDirtyCount() const {
+    int dirty = 0;
+    for (const auto& pair : buffer_pool) {
+        if (pair.second.block->is_dirty) dirty++;
+    }
+    return dirty;
+}
+
+size_t BufferManager::getDirtyBytes() const {
+    size_t bytes = 0;
+    for (const auto& pair : buffer_pool) {
+        if (pair.second.block->is_dirty) bytes += pair.second.charged_bytes;
+    }
+    return bytes;
+}
+
+long long BufferManager::getEvictions() const {
+    return evictions;
+}
+
+long long BufferManager::getEvictedBytes() const {
+    return evicted_bytes;
+}
+
+long long BufferManager::getDirtyEvictions() const {
+    return dirty_evictions;
+}
+
+size_t BufferManager::getMaxBytes() const {
+    return max_buffer_bytes;
+}
+
+size_t BufferManager::getUsedBytes() const {
+    return used_bytes;
+}
+
+size_t BufferManager::getMetadataMemory() const {
+    // Marcos del pool y nodos de la lista LRU
+    return buffer_pool.size() * (sizeof(std::pair<const int, Frame>) + 2 * sizeof(void*)) +
+           buffer_pool.bucket_count() * sizeof(void*) + 
+           lru_list.size() * (sizeof(int) + 2 * sizeof(void*));
+}
+
+int BufferManager::getResidentCount() const {
+    return static_cast<int>(buffer_pool.size());
 }
 
 void BufferManager::printBufferStatus() {
     std::cout << "\n=== Buffer Manager Status ===\n";
-    std::cout << "Blocks in buffer: " << buffer_pool.size() << "/" << max_buffer_size << "\n";
+    std::cout << "Blocks in buffer: " << buffer_pool.size() << " (" << used_bytes << "/" 
+              << max_buffer_bytes << " bytes)\n";
+    long long requests = hits + loads;
+    std::cout << "Hits: " << hits << ", loads from disk: " << loads 
+              << ", evictions: " << evictions;
+    if (requests > 0) {
+        std::cout << " (hit ratio " << 100.0 * hits / requests << "%)";
+    }
+    std::cout << "\n";
+    std::cout << "Dirty blocks: " << getDirtyCount() << " (" << getDirtyBytes() << " bytes); "
+              << dirty_evictions << " of " << evictions << " evictions had to write the victim\n";
+    std::cout << "Writes ahead of eviction (writer and checkpoints): " << background_writes
+              << ", checkpoints completed: " << checkpoints_completed;
+    if (checkpoints_completed > 0) {
+        std::cout << " (last: " << last_checkpoint_blocks << " blocks in " 
+                  << last_checkpoint_ms << " ms)";
+    }
+    if (checkpoint_active) {
+        std::cout << ", checkpoint in progress (" << checkpoint_pending.size() << " blocks left)";
+    }
+    std::cout << "\n";
     
-    for (const auto& pair : buffer_pool) {
-        std::cout << "Block " << pair.first << " (Dirty: " 
-                  << (pair.second->is_dirty ? "Yes" : "No") << ")\n";
+    for (int block_id : lru_list) {
+        const Frame& frame = buffer_pool.at(block_id);
+        std::cout << "Block " << block_id << " (Dirty: " 
+                  << (frame.block->is_dirty ? "Yes" : "No") << ", " << frame.charged_bytes 
+                  << " bytes" << (frame.block->pin_count > 0 ? ", pinned" : "") << ")\n";
     }
 }
 
 // ==================== DISK MANAGER ====================
 DiskManager::DiskManager(int num_platters, int surfaces, int tracks, int sectors, 
-            int sec_capacity, int rec_per_block, int buffer_size)
+            int sec_capacity, size_t buffer_bytes, int blk_size)
     : total_platters(num_platters), surfaces_per_platter(surfaces),
       tracks_per_surface(tracks), sectors_per_track(sectors),
-      sector_capacity(sec_capacity), records_per_block(rec_per_block),
-      next_record_id(1), next_block_id(1), buffer_manager(buffer_size) {
+      sector_capacity(sec_capacity),
+      block_size(blk_size > 0 ? blk_size : sec_capacity),
+      next_record_id(1), next_block_id(1), stored_block_bytes(0), buffer_manager(buffer_bytes),
+      output(&std::cout) {
+    
+    buffer_manager.attachDisk(this);
     
     // Inicializar estructura física del disco
     for (int p = 0; p < num_platters; ++p) {
@@ -179,7 +725,8 @@ DiskManager::DiskManager(int num_platters, int surfaces, int tracks, int sectors
     std::cout << "- Tracks per surface: " << tracks << "\n";
     std::cout << "- Sectors per track: " << sectors << "\n";
     std::cout << "- Sector capacity: " << sec_capacity << " bytes\n";
-    std::cout << "- Records per block: " << rec_per_block << "\n";
+    std::cout << "- Block size: " << block_size << " bytes (" 
+              << (block_size + sec_capacity - 1) / sec_capacity << " sectors)\n";
 }
 
 long long DiskManager::getTotalCapacity() const {
@@ -192,75 +739,362 @@ long long DiskManager::getUsedCapacity() const {
     for (const auto& platter : platters) {
         for (const auto& surface : platter.surfaces) {
             for (const auto& track : surface.tracks) {
-                for (const auto& sector : track.sectors) {
-                    used += sector.used_space;
-                }
+                used += track.getUsedSpace();
             }
         }
     }
     return used;
 }
 
+int DiskManager::getMaterializedTracks() const {
+    int materialized = 0;
+    for (const auto& platter : platters) {
+        for (const auto& surface : platter.surfaces) {
+            for (const auto& track : surface.tracks) {
+                if (track.isMaterialized()) materialized++;
+            }
+        }
+    }
+    return materialized;
+}
+
+size_t DiskManager::getMemoryUsage() const {
+    size_t memory = 0;
+    for (const auto& platter : platters) {
+        memory += sizeof(Platter);
+        for (const auto& surface : platter.surfaces) {
+            memory += sizeof(Surface);
+            for (const auto& track : surface.tracks) {
+                memory += track.getMemoryUsage();
+            }
+        }
+    }
+    return memory;
+}
+
 long long DiskManager::getFreeCapacity() const {
     return getTotalCapacity() - getUsedCapacity();
 }
 
-PhysicalLocation DiskManager::findLocationForBlock(int required_space) {
+std::vector<Extent> DiskManager::allocateExtents(int num_sectors) {
+    std::vector<Extent> extents;
+    if (num_sectors <= 0) return extents;
+    
+    // Primer intento: una sola extensión contigua dentro de una pista
     for (size_t p = 0; p < platters.size(); ++p) {
-        Surface* surface = platters[p].findSurfaceWithSpace(required_space);
-        if (surface != nullptr) {
-            Track* track = surface->findTrackWithSpace(required_space);
-            if (track != nullptr) {
-                Sector* sector = track->findSectorWithSpace(required_space);
-                if (sector != nullptr) {
-                    return PhysicalLocation(p, surface->surface_id, 
-                                          track->track_id, sector->sector_id, 
-                                          sector->used_space);
+        for (auto& surface : platters[p].surfaces) {
+            for (auto& track : surface.tracks) {
+                int start = track.findFreeRun(num_sectors);
+                if (start != -1) {
+                    extents.emplace_back(static_cast<int>(p), surface.surface_id,
+                                         track.track_id, start, num_sectors);
+                    track.reserveSectors(start, num_sectors);
+                    return extents;
+                }
+            }
+        }
+    }
+    
+    // Si no cabe en una pista, repartir en varias extensiones tomando los
+    // huecos de cada pista en orden (first-fit), también los cortos
+    int remaining = num_sectors;
+    for (size_t p = 0; p < platters.size() && remaining > 0; ++p) {
+        for (auto& surface : platters[p].surfaces) {
+            for (auto& track : surface.tracks) {
+                int from = 0;
+                while (remaining > 0) {
+                    int start;
+                    int length = track.nextFreeRun(from, start);
+                    if (length == 0) break;
+                    int taken = std::min(length, remaining);
+                    extents.emplace_back(static_cast<int>(p), surface.surface_id,
+                                         track.track_id, start, taken);
+                    track.reserveSectors(start, taken);
+                    remaining -= taken;
+                    from = start + taken;
                 }
+                if (remaining == 0) break;
             }
+            if (remaining == 0) break;
+        }
+    }
+    
+    if (remaining > 0) {
+        // No hay sectores suficientes: deshacer la reserva parcial
+        freeExtents(extents);
+        extents.clear();
+    }
+    return extents;
+}
+
+void DiskManager::freeExtents(const std::vector<Extent>& extents) {
+    for (const auto& extent : extents) {
+        Track& track = platters[extent.platter_id]
+                      .surfaces[extent.surface_id]
+                      .tracks[extent.track_id];
+        track.releaseSectors(extent.start_sector, extent.sector_count);
+    }
+}
+
+bool DiskManager::isValidExtent(const Extent& extent) const {
+    return extent.platter_id >= 0 && extent.platter_id < total_platters &&
+           extent.surface_id >= 0 && extent.surface_id < surfaces_per_platter &&
+           extent.track_id >= 0 && extent.track_id < tracks_per_surface &&
+           extent.start_sector >= 0 && extent.start_sector < sectors_per_track &&
+           extent.sector_count > 0 && extent.sector_count <= sectors_per_track - extent.start_sector;
+}
+
+int DiskManager::getExtentCapacity(const std::vector<Extent>& extents) const {
+    int sectors = 0;
+    for (const auto& extent : extents) {
+        sectors += extent.sector_count;
+    }
+    return sectors * sector_capacity;
+}
+
+bool DiskManager::writeExtents(const std::vector<Extent>& extents, const std::string& content) {
+    if (static_cast<int>(content.length()) > getExtentCapacity(extents)) {
+        return false;
+    }
+    
+    // Escritura secuencial: cada sector se llena completo antes de pasar al siguiente
+    size_t offset = 0;
+    for (const auto& extent : extents) {
+        Track& track = platters[extent.platter_id]
+                      .surfaces[extent.surface_id]
+                      .tracks[extent.track_id];
+        for (int i = 0; i < extent.sector_count; ++i) {
+            Sector& sector = track.getSector(extent.start_sector + i);
+            if (offset < content.length()) {
+                int position;
+                sector.clear();
+                sector.writeData(content.substr(offset, sector_capacity), position);
+                offset += sector_capacity;
+            } else {
+                // Sectores sobrantes del bloque: no guardan nada en memoria
+                sector.release();
+            }
+        }
+    }
+    return true;
+}
+
+std::string DiskManager::readExtents(const std::vector<Extent>& extents) const {
+    std::string content;
+    readExtents(extents, content);
+    return content;
+}
+
+void DiskManager::readExtents(const std::vector<Extent>& extents, std::string& content) const {
+    content.clear();
+    for (const auto& extent : extents) {
+        const Track& track = platters[extent.platter_id]
+                            .surfaces[extent.surface_id]
+                            .tracks[extent.track_id];
+        for (int i = 0; i < extent.sector_count; ++i) {
+            const Sector* sector = track.peekSector(extent.start_sector + i);
+            if (sector == nullptr) break;  // Pista sin escribir: nada que leer
+            content.append(sector->data.data(), sector->used_space);
         }
     }
-    return PhysicalLocation(); // Ubicación inválida
 }
 
 bool DiskManager::storeBlock(Block* block) {
     Timer timer;
     timer.start();
     
-    // Serializar el bloque para calcular el espacio requerido
-    std::string block_data = "";
-    for (const auto& record : block->records) {
-        block_data += record.serialize() + "\n";
+    // Serializar el bloque para calcular el espacio requerido.
+    // Se reserva la página completa del bloque para que pueda llenarse
+    // hasta su capacidad sin reubicarse.
+    std::string block_data = block->serialize();
+    int required_space = std::max(static_cast<int>(block_data.length()), 
+                                  std::max(block->capacity_bytes, 1));
+    int required_sectors = (required_space + sector_capacity - 1) / sector_capacity;
+    
+    std::vector<Extent> extents = allocateExtents(required_sectors);
+    if (extents.empty()) {
+        *output << "Error: No space available for block\n";
+        return false;
     }
     
-    int required_space = block_data.length();
-    PhysicalLocation location = findLocationForBlock(required_space);
+    if (!writeExtents(extents, block_data)) {
+        freeExtents(extents);
+        return false;
+    }
+    block->stored_bytes = block_data.length();
+    stored_block_bytes += static_cast<long long>(block->stored_bytes);
+    
+    const Extent& first = extents.front();
+    block->extents = extents;
+    block->location = PhysicalLocation(first.platter_id, first.surface_id,
+                                       first.track_id, first.start_sector, 0);
+    
+    double elapsed_time = timer.getElapsedTime();
+    *output << "Block " << block->block_id << " stored successfully in ";
+    *output << elapsed_time << " ms (" << required_sectors << " sectors in " 
+            << extents.size() << " extent(s)) at location: ";
+    block->location.print(*output);
     
-    if (location.platter_id == -1) {
-        std::cout << "Error: No space available for block\n";
+    return true;
+}
+
+bool DiskManager::writeBlock(Block* block) {
+    std::string block_data = block->serialize();
+    int capacity = getExtentCapacity(block->extents);
+    
+    if (static_cast<int>(block_data.length()) > capacity) {
+        // El bloque creció: añadir extensiones al final de su extent map
+        int missing = static_cast<int>(block_data.length()) - capacity;
+        int extra_sectors = (missing + sector_capacity - 1) / sector_capacity;
+        std::vector<Extent> extra = allocateExtents(extra_sectors);
+        if (extra.empty()) {
+            *output << "Error: No space available to grow block " 
+                    << block->block_id << "\n";
+            return false;
+        }
+        block->extents.insert(block->extents.end(), extra.begin(), extra.end());
+    }
+    // Si el bloque comprimido ocupa menos, los sectores sobrantes siguen
+    // reservados (la página completa): writeExtents solo libera su contenido
+    
+    if (!writeExtents(block->extents, block_data)) {
         return false;
     }
+    stored_block_bytes += static_cast<long long>(block_data.length()) - 
+                          static_cast<long long>(block->stored_bytes);
+    block->stored_bytes = block_data.length();
+    return true;
+}
+
+bool DiskManager::loadBlock(Block* block) {
+    if (block->extents.empty()) {
+        return false;
+    }
+    if (!block->deserialize(readExtents(block->extents))) {
+        *output << "Error: Block " << block->block_id << " is corrupted\n";
+        return false;
+    }
+    block->is_dirty = false;
+    return true;
+}
+
+void DiskManager::saveSectors(SnapshotWriter& out) const {
+    out.putI32(total_platters);
+    out.putI32(surfaces_per_platter);
+    out.putI32(tracks_per_surface);
+    out.putI32(sectors_per_track);
+    out.putI32(sector_capacity);
+    out.putI32(block_size);
     
-    // Escribir en el sector correspondiente
-    Sector& sector = platters[location.platter_id]
-                    .surfaces[location.surface_id]
-                    .tracks[location.track_id]
-                    .sectors[location.sector_id];
+    out.putU32(static_cast<uint32_t>(getMaterializedTracks()));
+    for (const auto& platter : platters) {
+        for (const auto& surface : platter.surfaces) {
+            for (const auto& track : surface.tracks) {
+                if (!track.isMaterialized()) continue;
+                
+                uint32_t in_use = 0;
+                for (const auto& sector : track.sectors) {
+                    if (!sector.isFree()) in_use++;
+                }
+                out.putI32(platter.platter_id);
+                out.putI32(surface.surface_id);
+                out.putI32(track.track_id);
+                out.putU32(in_use);
+                for (const auto& sector : track.sectors) {
+                    if (sector.isFree()) continue;
+                    out.putI32(sector.sector_id);
+                    out.putU8(sector.allocated ? 1 : 0);
+                    out.putU32(static_cast<uint32_t>(sector.data.size()));
+                    out.putBytes(sector.data.data(), sector.data.size());
+                }
+            }
+        }
+    }
+}
+
+bool DiskManager::loadSectors(SnapshotReader& in, std::string& error) {
+    int geometry[6];
+    for (int& value : geometry) {
+        if (!in.getI32(value)) {
+            error = "truncated disk section";
+            return false;
+        }
+    }
+    if (geometry[0] != total_platters || geometry[1] != surfaces_per_platter ||
+        geometry[2] != tracks_per_surface || geometry[3] != sectors_per_track ||
+        geometry[4] != sector_capacity || geometry[5] != block_size) {
+        error = "disk geometry differs from the snapshot";
+        return false;
+    }
+    if (getMaterializedTracks() > 0) {
+        error = "the disk is not empty";
+        return false;
+    }
     
-    int position;
-    if (sector.writeData(block_data, position)) {
-        block->location = PhysicalLocation(location.platter_id, location.surface_id,
-                                         location.track_id, location.sector_id, position);
-        
-        double elapsed_time = timer.getElapsedTime();
-        std::cout << "Block " << block->block_id << " stored successfully in ";
-        std::cout << elapsed_time << " ms at location: ";
-        block->location.print();
+    uint32_t track_count;
+    if (!in.getCount(track_count, 16)) {
+        error = "truncated disk section";
+        return false;
+    }
+    for (uint32_t t = 0; t < track_count; ++t) {
+        int platter_id, surface_id, track_id;
+        uint32_t sector_count;
+        if (!in.getI32(platter_id) || !in.getI32(surface_id) || !in.getI32(track_id) ||
+            !in.getCount(sector_count, 9) ||
+            platter_id < 0 || platter_id >= total_platters ||
+            surface_id < 0 || surface_id >= surfaces_per_platter ||
+            track_id < 0 || track_id >= tracks_per_surface) {
+            error = "invalid track in disk section";
+            return false;
+        }
+        Track& track = platters[platter_id].surfaces[surface_id].tracks[track_id];
         
-        return true;
+        for (uint32_t i = 0; i < sector_count; ++i) {
+            int sector_id;
+            bool allocated;
+            uint32_t length;
+            const char* bytes;
+            if (!in.getI32(sector_id) || !in.getBool(allocated) || !in.getU32(length) ||
+                sector_id < 0 || sector_id >= sectors_per_track ||
+                length > static_cast<uint32_t>(sector_capacity) || !in.getBytes(bytes, length)) {
+                error = "invalid sector in disk section";
+                return false;
+            }
+            if (allocated) {
+                track.reserveSectors(sector_id, 1);
+            }
+            Sector& sector = track.getSector(sector_id);
+            sector.data.assign(bytes, bytes + length);
+            sector.used_space = static_cast<int>(length);
+        }
     }
-    
-    return false;
+    return true;
+}
+
+void DiskManager::clearSectors() {
+    for (auto& platter : platters) {
+        for (auto& surface : platter.surfaces) {
+            for (auto& track : surface.tracks) {
+                track.releaseSectors(0, sectors_per_track);
+            }
+        }
+    }
+}
+
+long long DiskManager::getStoredBlockBytes() const {
+    return stored_block_bytes;
+}
+
+void DiskManager::addStoredBlockBytes(long long bytes) {
+    stored_block_bytes += bytes;
+}
+
+int DiskManager::getBlockSize() const {
+    return block_size;
+}
+
+int DiskManager::getSectorCapacity() const {
+    return sector_capacity;
 }
 
 void DiskManager::printDiskStatus() {
@@ -269,8 +1103,108 @@ void DiskManager::printDiskStatus() {
     std::cout << "Used Capacity: " << getUsedCapacity() << " bytes\n";
     std::cout << "Free Capacity: " << getFreeCapacity() << " bytes\n";
     std::cout << "Usage: " << (double)getUsedCapacity() / getTotalCapacity() * 100 << "%\n";
+    std::cout << "Materialized tracks: " << getMaterializedTracks() << " of " 
+              << total_platters * surfaces_per_platter * tracks_per_surface 
+              << " (" << getMemoryUsage() << " bytes in memory)\n";
 }
 
 BufferManager& DiskManager::getBufferManager() {
     return buffer_manager;
-}
\ No newline at end of file
+}
+
+void DiskManager::setOutput(std::ostream& stream) {
+    output = &stream;
+    buffer_manager.setOutput(stream);
+}
+
+std::ostream& DiskManager::getOutput() {
+    return *output;
+}
+
+size_t DiskManager::getBufferCapacity() const {
+    return buffer_manager.getMaxBytes();
+}
+
+// ==================== SPILL FILE ====================
+SpillFile::SpillFile(DiskManager* disk_manager)
+    : disk(disk_manager), page_size(disk_manager->getBlockSize()), total_bytes(0) {}
+
+SpillFile::~SpillFile() {
+    release();
+}
+
+bool SpillFile::append(const std::string& data) {
+    buffer += data;
+    total_bytes += static_cast<long long>(data.length());
+    while (static_cast<int>(buffer.length()) >= page_size) {
+        std::vector<Extent> extents = disk->allocateExtents(
+            (page_size + disk->getSectorCapacity() - 1) / disk->getSectorCapacity());
+        if (extents.empty()) {
+            disk->getOutput() << "Error: No space available for spill file\n";
+            return false;
+        }
+        if (!disk->writeExtents(extents, buffer.substr(0, page_size))) {
+            // Los sectores reservados no llegan a formar parte del fichero
+            disk->freeExtents(extents);
+            disk->getOutput() << "Error: Could not write spill file page\n";
+            return false;
+        }
+        pages.push_back(extents);
+        buffer.erase(0, page_size);
+    }
+    return true;
+}
+
+bool SpillFile::flush() {
+    if (buffer.empty()) {
+        return true;
+    }
+    int sectors = (static_cast<int>(buffer.length()) + disk->getSectorCapacity() - 1) 
+                  / disk->getSectorCapacity();
+    std::vector<Extent> extents = disk->allocateExtents(sectors);
+    if (extents.empty()) {
+        disk->getOutput() << "Error: No space available for spill file\n";
+        return false;
+    }
+    if (!disk->writeExtents(extents, buffer)) {
+        disk->freeExtents(extents);
+        disk->getOutput() << "Error: Could not write spill file page\n";
+        return false;
+    }
+    pages.push_back(extents);
+    buffer.clear();
+    return true;
+}
+
+int SpillFile::getPageCount() const {
+    return static_cast<int>(pages.size());
+}
+
+long long SpillFile::getSize() const {
+    return total_bytes;
+}
+
+bool SpillFile::readPage(int index, std::string& page) const {
+    if (index < 0 || index >= static_cast<int>(pages.size())) {
+        return false;
+    }
+    page = disk->readExtents(pages[index]);
+    return true;
+}
+
+std::string SpillFile::readAll() const {
+    std::string content;
+    for (const auto& extents : pages) {
+        content += disk->readExtents(extents);
+    }
+    return content + buffer;
+}
+
+void SpillFile::release() {
+    for (const auto& extents : pages) {
+        disk->freeExtents(extents);
+    }
+    pages.clear();
+    buffer.clear();
+    total_bytes = 0;
+}
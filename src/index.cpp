@@ -0,0 +1,347 @@
+#include "index.h"
+#include "query.h"
+#include <algorithm>
+
+// ==================== HASH INDEX ====================
+HashIndex::HashIndex(const std::string& attr) : attribute(attr), total_entries(0) {}
+
+const std::string& HashIndex::getAttribute() const {
+    return attribute;
+}
+
+void HashIndex::insert(const std::string& value, int record_id) {
+    entries[canonicalValue(value)].push_back(record_id);
+    total_entries++;
+}
+
+bool HashIndex::remove(const std::string& value, int record_id) {
+    auto it = entries.find(canonicalValue(value));
+    if (it == entries.end()) {
+        return false;
+    }
+    
+    std::vector<int>& ids = it->second;
+    auto pos = std::find(ids.begin(), ids.end(), record_id);
+    if (pos == ids.end()) {
+        return false;
+    }
+    ids.erase(pos);
+    total_entries--;
+    if (ids.empty()) {
+        entries.erase(it);
+    }
+    return true;
+}
+
+const std::vector<int>* HashIndex::lookup(const std::string& value) const {
+    auto it = entries.find(canonicalValue(value));
+    if (it == entries.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+int HashIndex::getEntryCount() const {
+    return total_entries;
+}
+
+int HashIndex::getDistinctValues() const {
+    return static_cast<int>(entries.size());
+}
+
+size_t HashIndex::getMemoryUsage() const {
+    // Tabla de cubetas más un nodo por valor distinto con su lista de IDs
+    const size_t node_size = sizeof(void*) + sizeof(size_t) + 
+                             sizeof(std::pair<const std::string, std::vector<int>>);
+    size_t bytes = sizeof(HashIndex) + entries.bucket_count() * sizeof(void*) + 
+                   entries.size() * node_size;
+    for (const auto& pair : entries) {
+        bytes += stringHeapMemory(pair.first) + pair.second.capacity() * sizeof(int);
+    }
+    return bytes;
+}
+
+void HashIndex::print() const {
+    std::cout << "Index on '" << attribute << "': " << total_entries 
+              << " entries, " << entries.size() << " distinct values\n";
+}
+
+void HashIndex::save(SnapshotWriter& out) const {
+    out.putString(attribute);
+    out.putU32(static_cast<uint32_t>(entries.size()));
+    for (const auto& pair : entries) {
+        out.putString(pair.first);
+        out.putU32(static_cast<uint32_t>(pair.second.size()));
+        for (int record_id : pair.second) {
+            out.putI32(record_id);
+        }
+    }
+}
+
+bool HashIndex::load(SnapshotReader& in) {
+    entries.clear();
+    total_entries = 0;
+    uint32_t count;
+    if (!in.getString(attribute) || !in.getCount(count, 8)) return false;
+    entries.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string value;
+        uint32_t id_count;
+        if (!in.getString(value) || !in.getCount(id_count, 4)) return false;
+        // Las instantáneas anteriores guardaban el valor tal cual: al pasarlo
+        // a forma canónica varias entradas pueden caer en la misma clave
+        std::vector<int>& ids = entries[canonicalValue(value)];
+        size_t first = ids.size();
+        ids.resize(first + id_count);
+        for (size_t j = first; j < ids.size(); ++j) {
+            in.getI32(ids[j]);
+        }
+        total_entries += static_cast<int>(id_count);
+    }
+    return true;
+}
+
+// ==================== PREFIX INDEX ====================
+PrefixIndex::Node::Node() : subtree_count(0) {}
+
+PrefixIndex::PrefixIndex(const std::string& attr) 
+    : attribute(attr), root(std::make_unique<Node>()), distinct_values(0), node_count(1) {}
+
+const std::string& PrefixIndex::getAttribute() const {
+    return attribute;
+}
+
+size_t PrefixIndex::childPosition(const Node& node, unsigned char first) {
+    size_t low = 0;
+    size_t high = node.children.size();
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (static_cast<unsigned char>(node.children[mid]->label[0]) < first) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void PrefixIndex::insert(const std::string& value, int record_id) {
+    Node* node = root.get();
+    node->subtree_count++;
+    size_t pos = 0;
+    
+    while (pos < value.length()) {
+        unsigned char first = static_cast<unsigned char>(value[pos]);
+        size_t index = childPosition(*node, first);
+        if (index == node->children.size() || 
+            static_cast<unsigned char>(node->children[index]->label[0]) != first) {
+            // Ningún valor comparte el siguiente byte: hoja con el resto del valor
+            auto leaf = std::make_unique<Node>();
+            leaf->label = value.substr(pos);
+            node->children.insert(node->children.begin() + index, std::move(leaf));
+            node_count++;
+            node = node->children[index].get();
+            node->subtree_count++;
+            break;
+        }
+        
+        Node* child = node->children[index].get();
+        size_t common = 0;
+        while (common < child->label.length() && pos + common < value.length() &&
+               child->label[common] == value[pos + common]) {
+            common++;
+        }
+        if (common < child->label.length()) {
+            // El valor se separa a mitad de la arista: partirla con un nodo intermedio
+            auto middle = std::make_unique<Node>();
+            middle->label = child->label.substr(0, common);
+            middle->subtree_count = child->subtree_count;
+            child->label.erase(0, common);
+            middle->children.push_back(std::move(node->children[index]));
+            node->children[index] = std::move(middle);
+            node_count++;
+            child = node->children[index].get();
+        }
+        node = child;
+        node->subtree_count++;
+        pos += common;
+    }
+    
+    if (node->record_ids.empty()) {
+        distinct_values++;
+    }
+    node->record_ids.push_back(record_id);
+}
+
+bool PrefixIndex::remove(const std::string& value, int record_id) {
+    // Camino desde la raíz hasta el nodo en el que termina el valor
+    std::vector<Node*> path = {root.get()};
+    size_t pos = 0;
+    while (pos < value.length()) {
+        Node* node = path.back();
+        unsigned char first = static_cast<unsigned char>(value[pos]);
+        size_t index = childPosition(*node, first);
+        if (index == node->children.size()) return false;
+        Node* child = node->children[index].get();
+        if (static_cast<unsigned char>(child->label[0]) != first ||
+            value.compare(pos, child->label.length(), child->label) != 0) {
+            return false;
+        }
+        path.push_back(child);
+        pos += child->label.length();
+    }
+    
+    Node* target = path.back();
+    auto it = std::find(target->record_ids.begin(), target->record_ids.end(), record_id);
+    if (it == target->record_ids.end()) {
+        return false;
+    }
+    target->record_ids.erase(it);
+    if (target->record_ids.empty()) {
+        distinct_values--;
+    }
+    for (Node* node : path) {
+        node->subtree_count--;
+    }
+    
+    // Mantener el árbol compacto: quitar hojas vacías y fundir con su hijo
+    // los nodos que se quedan sin IDs y con un único hijo
+    for (size_t depth = path.size() - 1; depth > 0; --depth) {
+        Node* node = path[depth];
+        Node* parent = path[depth - 1];
+        if (!node->record_ids.empty()) break;
+        size_t index = childPosition(*parent, static_cast<unsigned char>(node->label[0]));
+        if (node->children.empty()) {
+            parent->children.erase(parent->children.begin() + index);
+            node_count--;
+            continue;  // El padre puede haberse quedado compactable
+        }
+        if (node->children.size() == 1) {
+            std::unique_ptr<Node> child = std::move(node->children[0]);
+            child->label = node->label + child->label;
+            parent->children[index] = std::move(child);
+            node_count--;
+        }
+        break;
+    }
+    return true;
+}
+
+const PrefixIndex::Node* PrefixIndex::findPrefix(const std::string& prefix) const {
+    const Node* node = root.get();
+    size_t pos = 0;
+    while (pos < prefix.length()) {
+        unsigned char first = static_cast<unsigned char>(prefix[pos]);
+        size_t index = childPosition(*node, first);
+        if (index == node->children.size()) return nullptr;
+        const Node* child = node->children[index].get();
+        if (static_cast<unsigned char>(child->label[0]) != first) return nullptr;
+        
+        // El prefijo puede terminar a mitad de la etiqueta: entonces todo el
+        // subárbol del hijo lo comparte
+        size_t length = std::min(child->label.length(), prefix.length() - pos);
+        if (prefix.compare(pos, length, child->label, 0, length) != 0) return nullptr;
+        node = child;
+        pos += length;
+    }
+    return node;
+}
+
+void PrefixIndex::collect(const Node& node, std::vector<int>& record_ids) {
+    record_ids.insert(record_ids.end(), node.record_ids.begin(), node.record_ids.end());
+    for (const auto& child : node.children) {
+        collect(*child, record_ids);
+    }
+}
+
+int PrefixIndex::countPrefix(const std::string& prefix) const {
+    const Node* node = findPrefix(prefix);
+    return (node != nullptr) ? node->subtree_count : 0;
+}
+
+std::vector<int> PrefixIndex::lookupPrefix(const std::string& prefix) const {
+    std::vector<int> record_ids;
+    const Node* node = findPrefix(prefix);
+    if (node != nullptr) {
+        record_ids.reserve(node->subtree_count);
+        collect(*node, record_ids);
+    }
+    return record_ids;
+}
+
+int PrefixIndex::getEntryCount() const {
+    return root->subtree_count;
+}
+
+int PrefixIndex::getDistinctValues() const {
+    return distinct_values;
+}
+
+size_t PrefixIndex::nodeMemory(const Node& node) const {
+    size_t bytes = sizeof(Node) + stringHeapMemory(node.label) + 
+                   node.record_ids.capacity() * sizeof(int) +
+                   node.children.capacity() * sizeof(std::unique_ptr<Node>);
+    for (const auto& child : node.children) {
+        bytes += nodeMemory(*child);
+    }
+    return bytes;
+}
+
+size_t PrefixIndex::getMemoryUsage() const {
+    return sizeof(PrefixIndex) + nodeMemory(*root);
+}
+
+void PrefixIndex::print() const {
+    std::cout << "Prefix index on '" << attribute << "': " << getEntryCount() 
+              << " entries, " << distinct_values << " distinct values, " 
+              << node_count << " nodes\n";
+}
+
+void PrefixIndex::saveNode(const Node& node, SnapshotWriter& out) {
+    out.putString(node.label);
+    out.putU32(static_cast<uint32_t>(node.record_ids.size()));
+    for (int record_id : node.record_ids) {
+        out.putI32(record_id);
+    }
+    out.putU32(static_cast<uint32_t>(node.children.size()));
+    for (const auto& child : node.children) {
+        saveNode(*child, out);
+    }
+}
+
+bool PrefixIndex::loadNode(Node& node, SnapshotReader& in, int depth) {
+    // La profundidad se acota para que datos corruptos no agoten la pila;
+    // cada nivel consume al menos un byte del valor
+    uint32_t id_count, child_count;
+    if (depth > MAX_LOAD_DEPTH || !in.getString(node.label) || !in.getCount(id_count, 4)) {
+        return false;
+    }
+    node.record_ids.resize(id_count);
+    for (int& record_id : node.record_ids) {
+        in.getI32(record_id);
+    }
+    if (!in.getCount(child_count, 8)) return false;
+    
+    node_count++;
+    if (id_count > 0) distinct_values++;
+    node.subtree_count = static_cast<int>(id_count);
+    node.children.reserve(child_count);
+    for (uint32_t i = 0; i < child_count; ++i) {
+        node.children.push_back(std::make_unique<Node>());
+        if (!loadNode(*node.children.back(), in, depth + 1)) return false;
+        node.subtree_count += node.children.back()->subtree_count;
+    }
+    return true;
+}
+
+void PrefixIndex::save(SnapshotWriter& out) const {
+    out.putString(attribute);
+    saveNode(*root, out);
+}
+
+bool PrefixIndex::load(SnapshotReader& in) {
+    root = std::make_unique<Node>();
+    distinct_values = 0;
+    node_count = 0;
+    return in.getString(attribute) && loadNode(*root, in, 0);
+}
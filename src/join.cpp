@@ -0,0 +1,224 @@
+#include "join.h"
+#include "query.h"
+#include <cstring>
+#include <functional>
+
+// ==================== HASH JOIN ====================
+HashJoinOperator::HashJoinOperator(DiskManager* disk_manager, const std::string& left_attribute,
+                                   const std::string& right_attribute, long long budget_bytes)
+    : disk(disk_manager), left_key(left_attribute), right_key(right_attribute),
+      memory_budget(budget_bytes), partitions_used(0) {}
+
+long long HashJoinOperator::estimateBytes(const std::vector<Block*>& blocks) {
+    long long bytes = 0;
+    for (const Block* block : blocks) {
+        bytes += block->used_bytes;
+    }
+    return bytes;
+}
+
+bool HashJoinOperator::execute(const std::vector<Block*>& left_blocks,
+                               const std::vector<Block*>& right_blocks,
+                               std::vector<JoinedRow>& results) {
+    results.clear();
+    partitions_used = 0;
+    
+    // Construir sobre el lado más pequeño
+    long long left_bytes = estimateBytes(left_blocks);
+    long long right_bytes = estimateBytes(right_blocks);
+    bool build_is_left = left_bytes <= right_bytes;
+    
+    const std::vector<Block*>& build = build_is_left ? left_blocks : right_blocks;
+    const std::vector<Block*>& probe = build_is_left ? right_blocks : left_blocks;
+    const std::string& build_key = build_is_left ? left_key : right_key;
+    const std::string& probe_key = build_is_left ? right_key : left_key;
+    long long build_bytes = std::min(left_bytes, right_bytes);
+    
+    // La tabla hash guarda copias de los registros, que ocupan en memoria
+    // bastante más que codificados: el presupuesto se comprueba mientras se
+    // construye y, si se supera, se pasa a la variante grace
+    long long memory_bytes = 0;
+    bool success = false;
+    bool over_budget = build_bytes > memory_budget;
+    if (!over_budget) {
+        success = inMemoryJoin(build, build_key, probe, probe_key, build_is_left, 
+                               results, over_budget, memory_bytes);
+    }
+    if (over_budget) {
+        results.clear();
+        // Suficientes particiones para que cada una quepa en el presupuesto,
+        // con la memoria estimada por la parte ya construida (si la hubo)
+        long long needed = std::max(build_bytes, memory_bytes);
+        int num_partitions = static_cast<int>(
+            (needed + memory_budget - 1) / std::max(memory_budget, 1LL)) * 2;
+        success = graceJoin(build, build_key, probe, probe_key, build_is_left, 
+                            std::max(num_partitions, 2), results);
+    }
+    if (!success) {
+        results.clear();
+    }
+    return success;
+}
+
+bool HashJoinOperator::forEachRecord(const std::vector<Block*>& blocks,
+                                     const std::function<bool(const Record&)>& consumer) {
+    for (Block* block : blocks) {
+        BlockPin pin(disk->getBufferManager(), block);
+        if (pin.get() == nullptr) return false;
+        for (const auto& record : block->records) {
+            if (record.is_deleted) continue;
+            if (!consumer(record)) return false;
+        }
+    }
+    return true;
+}
+
+bool HashJoinOperator::inMemoryJoin(const std::vector<Block*>& build, const std::string& build_key,
+                                    const std::vector<Block*>& probe, const std::string& probe_key,
+                                    bool build_is_left, std::vector<JoinedRow>& results,
+                                    bool& over_budget, long long& memory_bytes) {
+    // Cada copia se contabiliza como en SortOperator: el objeto y su mapa
+    std::unordered_map<std::string, std::vector<Record>> table;
+    long long encoded_bytes = 0;
+    bool built = forEachRecord(build, [&](const Record& record) {
+        auto it = record.data.find(build_key);
+        if (it != record.data.end() && !it->second.empty()) {
+            table[canonicalValue(it->second)].push_back(record);
+            memory_bytes += static_cast<long long>(sizeof(Record) + record.getHeapMemory());
+        }
+        encoded_bytes += Block::encodedSize(record);
+        return memory_bytes <= memory_budget;
+    });
+    if (memory_bytes > memory_budget) {
+        // Extrapolar la memoria del lado completo a partir de lo construido
+        over_budget = true;
+        long long total_bytes = estimateBytes(build);
+        if (encoded_bytes > 0 && total_bytes > encoded_bytes) {
+            memory_bytes = static_cast<long long>(
+                static_cast<double>(memory_bytes) * total_bytes / encoded_bytes);
+        }
+        return false;
+    }
+    if (!built) return false;
+    
+    return forEachRecord(probe, [&](const Record& record) {
+        auto it = record.data.find(probe_key);
+        if (it == record.data.end() || it->second.empty()) return true;
+        auto match = table.find(canonicalValue(it->second));
+        if (match == table.end()) return true;
+        for (const Record& build_record : match->second) {
+            if (build_is_left) {
+                results.push_back(JoinedRow{build_record, record});
+            } else {
+                results.push_back(JoinedRow{record, build_record});
+            }
+        }
+        return true;
+    });
+}
+
+// Formato de cada entrada en una partición: longitud de la clave (4 bytes),
+// clave, longitud del registro serializado (4 bytes) y registro
+static void appendField(std::string& out, const std::string& field) {
+    uint32_t length = static_cast<uint32_t>(field.length());
+    out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.append(field);
+}
+
+static bool readField(const std::string& in, size_t& pos, std::string& field) {
+    uint32_t length;
+    if (pos + sizeof(length) > in.length()) return false;
+    std::memcpy(&length, in.data() + pos, sizeof(length));
+    pos += sizeof(length);
+    if (pos + length > in.length()) return false;
+    field.assign(in, pos, length);
+    pos += length;
+    return true;
+}
+
+static bool readEntry(const std::string& in, size_t& pos, std::string& key, Record& record) {
+    std::string serialized;
+    if (!readField(in, pos, key) || !readField(in, pos, serialized)) return false;
+    record = Record::deserialize(serialized);
+    return true;
+}
+
+bool HashJoinOperator::partition(const std::vector<Block*>& blocks, const std::string& key,
+                                 std::vector<SpillFile*>& partitions) {
+    std::hash<std::string> hasher;
+    std::string entry;
+    bool written = forEachRecord(blocks, [&](const Record& record) {
+        auto it = record.data.find(key);
+        if (it == record.data.end() || it->second.empty()) return true;
+        
+        // La clave canónica hace que "7" y "7.0" caigan en la misma partición
+        // y coincidan en la tabla hash, como en las igualdades del WHERE
+        std::string canonical = canonicalValue(it->second);
+        entry.clear();
+        appendField(entry, canonical);
+        appendField(entry, record.serialize());
+        size_t target = hasher(canonical) % partitions.size();
+        return partitions[target]->append(entry);
+    });
+    if (!written) return false;
+    for (SpillFile* spill : partitions) {
+        if (!spill->flush()) return false;
+    }
+    return true;
+}
+
+bool HashJoinOperator::graceJoin(const std::vector<Block*>& build, const std::string& build_key,
+                                 const std::vector<Block*>& probe, const std::string& probe_key,
+                                 bool build_is_left, int num_partitions, 
+                                 std::vector<JoinedRow>& results) {
+    partitions_used = num_partitions;
+    std::vector<SpillFile*> build_parts;
+    std::vector<SpillFile*> probe_parts;
+    for (int i = 0; i < num_partitions; ++i) {
+        build_parts.push_back(new SpillFile(disk));
+        probe_parts.push_back(new SpillFile(disk));
+    }
+    
+    // Fase 1: particionar ambos lados en el disco
+    bool success = partition(build, build_key, build_parts) && 
+                   partition(probe, probe_key, probe_parts);
+    
+    // Fase 2: unir cada par de particiones con una tabla hash en memoria
+    for (int i = 0; success && i < num_partitions; ++i) {
+        std::unordered_map<std::string, std::vector<Record>> table;
+        std::string data = build_parts[i]->readAll();
+        build_parts[i]->release();
+        
+        std::string key;
+        Record record;
+        size_t pos = 0;
+        while (readEntry(data, pos, key, record)) {
+            table[key].push_back(record);
+        }
+        
+        data = probe_parts[i]->readAll();
+        probe_parts[i]->release();
+        pos = 0;
+        while (readEntry(data, pos, key, record)) {
+            auto match = table.find(key);
+            if (match == table.end()) continue;
+            for (const Record& build_record : match->second) {
+                if (build_is_left) {
+                    results.push_back(JoinedRow{build_record, record});
+                } else {
+                    results.push_back(JoinedRow{record, build_record});
+                }
+            }
+        }
+    }
+    
+    for (int i = 0; i < num_partitions; ++i) {
+        delete build_parts[i];
+        delete probe_parts[i];
+    }
+    return success;
+}
+
+int HashJoinOperator::getPartitionCount() const {
+    return partitions_used;
+}
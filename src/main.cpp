@@ -1,5 +1,7 @@
 #include "sgbd.h"
 #include <iostream>
+#include <cstdio>
+#include <thread>
 
 // Función principal de demostración
 int main() {
@@ -8,18 +10,23 @@ int main() {
     // Crear archivos de ejemplo
     createTitanicSample();
     createHousingSample();
+    createPortsSample();
     
     // Configuración del disco:
     // 2 platos, 2 superficies por plato, 10 pistas por superficie
-    // 8 sectores por pista, 512 bytes por sector, 5 registros por bloque
-    // Buffer de 10 bloques
-    SGBD system(2, 2, 10, 8, 512, 5, 10);
+    // 8 sectores por pista, 512 bytes por sector
+    // Buffer de 32 KB para registros cargados, páginas de 2 KB (4 sectores contiguos por bloque)
+    // llenadas hasta el 90% para dejar sitio a actualizaciones
+    SGBD system(2, 2, 10, 8, 512, 32 * 1024, 2048, 0.9);
     
     std::cout << "\n=== Loading Titanic Data ===\n";
-    system.loadFromCSV("titanic_sample.csv");
+    system.loadFromCSV("titanic_sample.csv", "titanic");
     
     std::cout << "\n=== Loading Housing Data ===\n";
-    system.loadFromCSV("housing_sample.csv");
+    system.loadFromCSV("housing_sample.csv", "housing");
+    
+    std::cout << "\n=== Loading Ports Data ===\n";
+    system.loadFromCSV("ports_sample.csv", "ports");
     
     std::cout << "\n=== Adding Individual Record ===\n";
     std::map<std::string, std::string> individual_record = {
@@ -28,22 +35,155 @@ int main() {
         {"city", "New York"}
     };
     Record new_record(individual_record, 999);
-    system.addRecord(new_record);
+    system.addRecord(new_record, "people");
+    
+    std::cout << "\n=== Batch Insert ===\n";
+    std::vector<Record> events;
+    for (int i = 0; i < 200; ++i) {
+        std::map<std::string, std::string> event_data = {
+            {"event", (i % 3 == 0) ? "login" : "click"},
+            {"user", std::to_string(i % 17)}
+        };
+        events.emplace_back(event_data, 10000 + i);
+    }
+    system.addRecords(events, "events");
     
     std::cout << "\n=== Querying Single Record ===\n";
-    Record* found = system.findRecord(1);
-    if (found) {
-        found->print();
+    Record found;
+    if (system.findRecord(1, found)) {
+        found.print();
     }
     
     std::cout << "\n=== Querying Records by Attribute ===\n";
-    auto results = system.findRecordsByAttribute("Sex", "female", "=");
+    auto results = system.findRecordsByAttribute("Sex", "female", "=", "titanic");
     std::cout << "Female passengers:\n";
-    for (Record* record : results) {
-        record->print();
+    for (const Record& record : results) {
+        record.print();
         std::cout << "---\n";
     }
     
+    std::cout << "\n=== Compound Query with Index ===\n";
+    system.createIndex("Sex");
+    auto compound = system.query("Sex = 'female' AND (Pclass = 1 OR Age < 30)");
+    for (Record& record : compound) {
+        std::cout << "  " << record.data["Name"] << "\n";
+    }
+    
+    std::cout << "\n=== Column Statistics and Cardinality Estimates ===\n";
+    system.analyze("titanic");
+    system.query("Fare >= 50 AND Sex = 'female'", "titanic");
+    
+    std::cout << "\n=== Aggregation: Average Fare by Class ===\n";
+    system.aggregate({"Pclass"}, {"COUNT(*)", "AVG(Fare)", "MIN(Age)", "MAX(Age)"},
+                     "", "titanic");
+    
+    std::cout << "\n=== Hash Join: Passengers with Port of Embarkation ===\n";
+    auto joined = system.hashJoin("titanic", "Embarked", "ports", "Embarked");
+    for (JoinedRow& row : joined) {
+        std::cout << "  " << row.left.data["Name"] << " -> " << row.right.data["Port"] << "\n";
+    }
+    // Con un presupuesto mínimo se fuerza la variante grace con particiones en disco
+    system.hashJoin("titanic", "Embarked", "ports", "Embarked", 64);
+    
+    std::cout << "\n=== ORDER BY Fare DESC ===\n";
+    for (const Record& record : system.orderBy("titanic", "Fare DESC")) {
+        std::cout << "  " << record.data.at("Fare") << "\t" << record.data.at("Name") << "\n";
+    }
+    // Top-K y ordenación externa forzada con un presupuesto de memoria mínimo
+    system.orderBy("titanic", "Age, Name", 2);
+    system.orderBy("titanic", "Age DESC", 0, "", 200);
+    
+    std::cout << "\n=== Range Query Pruned by Zone Maps ===\n";
+    system.query("PassengerId > 900000");
+    system.query("Fare > 500 OR Age > 60", "titanic");
+    
+    std::cout << "\n=== Equality Query Pruned by Bloom Filters ===\n";
+    system.createBloomFilter("titanic", "Ticket", 0.01);
+    system.query("Ticket = '113803'", "titanic");
+    system.query("Ticket = 'NO-SUCH-TICKET'", "titanic");
+    
+    std::cout << "\n=== Prefix Queries (LIKE) ===\n";
+    system.query("Ticket LIKE 'PC%'", "titanic");
+    system.createPrefixIndex("Name");
+    system.query("Name LIKE 'Allen%'", "titanic");
+    system.query("Name LIKE 'Cum%' AND Pclass = 1", "titanic");
+    
+    std::cout << "\n=== Result Cache ===\n";
+    system.setResultCacheCapacity(16 * 1024);
+    system.query("Embarked = 'S' AND Age >= 30", "titanic");
+    system.query("Age >= 30 AND Embarked = 'S'", "titanic");  // Misma forma normalizada
+    // Una inserción en la tabla invalida solo las entradas que leen sus atributos
+    std::map<std::string, std::string> late_passenger = {
+        {"PassengerId", "900"}, {"Name", "Late Passenger"}, {"Age", "41"}, {"Embarked", "S"}
+    };
+    system.addRecord(Record(late_passenger, 900), "titanic");
+    system.query("Embarked = 'S' AND Age >= 30", "titanic");
+    system.query("Embarked = 'S' AND Age >= 30", "titanic");
+    
+    std::cout << "\n=== Updating Records ===\n";
+    system.updateRecords("Pclass = 3", {{"Cabin", "G6"}}, "titanic");
+    system.updateRecords("PassengerId = 1", {{"Cabin", std::string(1500, 'X')}}, "titanic");
+    system.query("Cabin = 'G6'", "titanic");
+    
+    std::cout << "\n=== Background Writer and Fuzzy Checkpoints ===\n";
+    // 256 KB/s de presupuesto de escritura, rondas cada 10 ms, checkpoint cada 100 ms.
+    // Los desalojos de la carga del CSV ya van en los contadores del buffer:
+    // se anotan para contar solo los de esta fase.
+    long long evictions_before, dirty_before;
+    system.getEvictionStats(evictions_before, dirty_before);
+    system.startBackgroundWriter(WriterConfig(256 * 1024, 10, 16, 100));
+    // Lotes pequeños con pausas: entre operaciones el escritor limpia los
+    // bloques que el siguiente lote desalojará
+    for (int round = 0; round < 8; ++round) {
+        std::vector<Record> metrics;
+        for (int i = 0; i < 50; ++i) {
+            std::map<std::string, std::string> metric_data = {
+                {"sensor", "s" + std::to_string(i % 8)},
+                {"reading", std::to_string((round * 50 + i) * 37 % 1000)}
+            };
+            metrics.emplace_back(metric_data, system.allocateRecordId());
+        }
+        system.addRecords(metrics, "metrics");
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+    system.checkpoint();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    long long evictions_after, dirty_after;
+    system.getEvictionStats(evictions_after, dirty_after);
+    std::cout << "Evictions while the writer ran: " << evictions_after - evictions_before
+              << ", " << dirty_after - dirty_before << " had to write the victim\n";
+    
+    std::cout << "\n=== Record Views ===\n";
+    // Solo se decodifican las columnas consultadas; el Record completo se
+    // construye únicamente para el registro que se quiere conservar
+    Predicate survivors;
+    std::string view_error;
+    Predicate::parse("Survived = 1 AND Pclass = 1", survivors, view_error);
+    double fare_total = 0;
+    Record first_survivor;
+    long long survivor_count = system.scan(survivors, [&](const RecordView& view) {
+        std::string_view fare;
+        double value;
+        if (view.get("Fare", fare) && parseNumber(fare, value)) {
+            fare_total += value;
+        }
+        if (first_survivor.record_id < 0) {
+            first_survivor = view.materialize();
+        }
+        return true;
+    }, "titanic");
+    std::cout << "First-class survivors: " << survivor_count << ", total fare " 
+              << fare_total << "\n";
+    if (first_survivor.record_id >= 0) {
+        first_survivor.print();
+    }
+    system.lookup(3, [](const RecordView& view) {
+        std::string_view name;
+        if (view.get("Name", name)) {
+            std::cout << "Record " << view.getId() << ": " << name << "\n";
+        }
+    });
+    
     std::cout << "\n=== Querying All Records ===\n";
     auto all_records = system.getAllRecords();
     std::cout << "Total active records: " << all_records.size() << "\n";
@@ -57,6 +197,25 @@ int main() {
     std::cout << "\n=== System Statistics ===\n";
     system.showSystemStats();
     
+    std::cout << "\n=== Snapshot Save / Load ===\n";
+    if (system.saveSnapshot("sgbd_snapshot.bin")) {
+        // Misma geometría que la instancia original
+        SGBD restored(2, 2, 10, 8, 512, 32 * 1024, 2048, 0.9);
+        restored.loadSnapshot("sgbd_snapshot.bin");
+        // El fichero sigue mapeado: puede borrarse antes de usar los índices
+        std::remove("sgbd_snapshot.bin");
+        
+        Predicate third_class;
+        Predicate::parse("Pclass = 3", third_class, view_error);
+        long long third_class_count = restored.scan(third_class, [](const RecordView&) {
+            return true;
+        }, "titanic");
+        std::cout << "Third-class passengers after restart: " << third_class_count << "\n";
+        // Primera consulta con índice: reconstruye el mapa de ubicaciones y los índices
+        auto restored_allens = restored.query("Name LIKE 'Allen%'", "titanic");
+        std::cout << "Name LIKE 'Allen%' after restart: " << restored_allens.size() << " records\n";
+    }
+    
     std::cout << "\n=== Simulation Tests ===\n";
     system.simulateFullBlock();
     system.simulateFullSectors();
@@ -0,0 +1,252 @@
+#include "protocol.h"
+
+namespace protocol {
+
+Request::Request()
+    : request_id(0), opcode(Opcode::PING), record_id(0), limit(0) {}
+
+Response::Response()
+    : request_id(0), status(Status::OK), count(0), record_id(0) {}
+
+// ==================== WRITER ====================
+Writer::Writer(std::string& buffer) : out(buffer), frame_start(0) {}
+
+void Writer::beginFrame() {
+    frame_start = out.size();
+    putU32(0);
+}
+
+void Writer::endFrame() {
+    uint32_t length = static_cast<uint32_t>(out.size() - frame_start - 4);
+    for (int i = 0; i < 4; ++i) {
+        out[frame_start + i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+    }
+}
+
+void Writer::putU8(uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+void Writer::putU32(uint32_t value) {
+    char bytes[4];
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+    out.append(bytes, 4);
+}
+
+void Writer::putString(const std::string& value) {
+    putU32(static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+void Writer::putFields(const std::map<std::string, std::string>& fields) {
+    putU32(static_cast<uint32_t>(fields.size()));
+    for (const auto& pair : fields) {
+        putString(pair.first);
+        putString(pair.second);
+    }
+}
+
+void Writer::putRecord(const Record& record) {
+    putU32(static_cast<uint32_t>(record.record_id));
+    putFields(record.data);
+}
+
+size_t Writer::recordSize(const Record& record) {
+    size_t bytes = 2 * sizeof(uint32_t);  // ID y número de campos
+    for (const auto& pair : record.data) {
+        bytes += 2 * sizeof(uint32_t) + pair.first.size() + pair.second.size();
+    }
+    return bytes;
+}
+
+// ==================== READER ====================
+Reader::Reader(const char* payload, size_t length) : data(payload), size(length), pos(0) {}
+
+bool Reader::getU8(uint8_t& value) {
+    if (size - pos < 1) return false;
+    value = static_cast<uint8_t>(data[pos++]);
+    return true;
+}
+
+bool Reader::getU32(uint32_t& value) {
+    if (size - pos < 4) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+    }
+    pos += 4;
+    return true;
+}
+
+bool Reader::getString(std::string& value) {
+    uint32_t length;
+    if (!getU32(length) || size - pos < length) return false;
+    value.assign(data + pos, length);
+    pos += length;
+    return true;
+}
+
+bool Reader::getFields(std::map<std::string, std::string>& fields) {
+    uint32_t count;
+    if (!getU32(count)) return false;
+    fields.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string key;
+        std::string value;
+        if (!getString(key) || !getString(value)) return false;
+        fields.emplace_hint(fields.end(), std::move(key), std::move(value));
+    }
+    return true;
+}
+
+bool Reader::getRecord(Record& record) {
+    uint32_t id;
+    if (!getU32(id) || !getFields(record.data)) return false;
+    record.record_id = static_cast<int>(id);
+    record.is_deleted = false;
+    return true;
+}
+
+bool Reader::atEnd() const {
+    return pos == size;
+}
+
+// ==================== FRAMING ====================
+int nextFrame(const std::string& buffer, size_t& offset,
+              const char*& payload, uint32_t& length) {
+    if (buffer.size() - offset < 4) return 0;
+
+    Reader header(buffer.data() + offset, 4);
+    header.getU32(length);
+    if (length > MAX_FRAME_BYTES) return -1;
+    if (buffer.size() - offset - 4 < length) return 0;
+
+    payload = buffer.data() + offset + 4;
+    offset += 4 + length;
+    return 1;
+}
+
+void encodeRequest(const Request& request, std::string& out) {
+    Writer writer(out);
+    writer.beginFrame();
+    writer.putU32(request.request_id);
+    writer.putU8(static_cast<uint8_t>(request.opcode));
+
+    switch (request.opcode) {
+        case Opcode::PING:
+            break;
+        case Opcode::INSERT:
+            writer.putString(request.table);
+            writer.putU32(request.record_id);
+            writer.putFields(request.fields);
+            break;
+        case Opcode::QUERY:
+            writer.putString(request.table);
+            writer.putString(request.text);
+            writer.putU32(request.limit);
+            break;
+        case Opcode::GET:
+        case Opcode::DELETE:
+            writer.putU32(request.record_id);
+            break;
+        case Opcode::UPDATE:
+            writer.putString(request.table);
+            writer.putString(request.text);
+            writer.putFields(request.fields);
+            break;
+    }
+    writer.endFrame();
+}
+
+bool decodeRequest(const char* payload, uint32_t length, Request& request, std::string& error) {
+    Reader reader(payload, length);
+    uint8_t opcode;
+    if (!reader.getU32(request.request_id) || !reader.getU8(opcode)) {
+        error = "Truncated request header";
+        return false;
+    }
+
+    bool ok = true;
+    request.opcode = static_cast<Opcode>(opcode);
+    switch (request.opcode) {
+        case Opcode::PING:
+            break;
+        case Opcode::INSERT:
+            ok = reader.getString(request.table) && reader.getU32(request.record_id) &&
+                 reader.getFields(request.fields);
+            break;
+        case Opcode::QUERY:
+            ok = reader.getString(request.table) && reader.getString(request.text) &&
+                 reader.getU32(request.limit);
+            break;
+        case Opcode::GET:
+        case Opcode::DELETE:
+            ok = reader.getU32(request.record_id);
+            break;
+        case Opcode::UPDATE:
+            ok = reader.getString(request.table) && reader.getString(request.text) &&
+                 reader.getFields(request.fields);
+            break;
+        default:
+            error = "Unknown opcode " + std::to_string(opcode);
+            return false;
+    }
+
+    if (!ok || !reader.atEnd()) {
+        error = std::string("Malformed ") + opcodeToString(request.opcode) + " request";
+        return false;
+    }
+    return true;
+}
+
+void encodeResponse(const Response& response, const std::vector<const Record*>& records,
+                    std::string& out) {
+    Writer writer(out);
+    writer.beginFrame();
+    writer.putU32(response.request_id);
+    writer.putU8(static_cast<uint8_t>(response.status));
+    writer.putU32(response.count);
+    writer.putU32(response.record_id);
+    writer.putString(response.message);
+    writer.putU32(static_cast<uint32_t>(records.size()));
+    for (const Record* record : records) {
+        writer.putRecord(*record);
+    }
+    writer.endFrame();
+}
+
+bool decodeResponse(const char* payload, uint32_t length, Response& response) {
+    Reader reader(payload, length);
+    uint8_t status;
+    uint32_t record_count;
+    if (!reader.getU32(response.request_id) || !reader.getU8(status) ||
+        !reader.getU32(response.count) || !reader.getU32(response.record_id) ||
+        !reader.getString(response.message) || !reader.getU32(record_count)) {
+        return false;
+    }
+    response.status = static_cast<Status>(status);
+
+    response.records.clear();
+    for (uint32_t i = 0; i < record_count; ++i) {
+        Record record;
+        if (!reader.getRecord(record)) return false;
+        response.records.push_back(std::move(record));
+    }
+    return reader.atEnd();
+}
+
+const char* opcodeToString(Opcode opcode) {
+    switch (opcode) {
+        case Opcode::PING: return "PING";
+        case Opcode::INSERT: return "INSERT";
+        case Opcode::QUERY: return "QUERY";
+        case Opcode::GET: return "GET";
+        case Opcode::DELETE: return "DELETE";
+        case Opcode::UPDATE: return "UPDATE";
+    }
+    return "UNKNOWN";
+}
+
+} // namespace protocol
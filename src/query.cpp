@@ -0,0 +1,540 @@
+#include "query.h"
+#include "record_view.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// ==================== OPERADORES ====================
+bool parseCompareOp(const std::string& text, CompareOp& op) {
+    if (text == "=" || text == "==") op = CompareOp::EQ;
+    else if (text == "!=" || text == "<>") op = CompareOp::NE;
+    else if (text == "<") op = CompareOp::LT;
+    else if (text == "<=") op = CompareOp::LE;
+    else if (text == ">") op = CompareOp::GT;
+    else if (text == ">=") op = CompareOp::GE;
+    else if (text.length() == 4 && 
+             std::toupper(static_cast<unsigned char>(text[0])) == 'L' &&
+             std::toupper(static_cast<unsigned char>(text[1])) == 'I' &&
+             std::toupper(static_cast<unsigned char>(text[2])) == 'K' &&
+             std::toupper(static_cast<unsigned char>(text[3])) == 'E') op = CompareOp::PREFIX;
+    else return false;
+    return true;
+}
+
+std::string compareOpToString(CompareOp op) {
+    switch (op) {
+        case CompareOp::EQ: return "=";
+        case CompareOp::NE: return "!=";
+        case CompareOp::LT: return "<";
+        case CompareOp::LE: return "<=";
+        case CompareOp::GT: return ">";
+        case CompareOp::GE: return ">=";
+        case CompareOp::PREFIX: return "LIKE";
+    }
+    return "?";
+}
+
+bool parseLikePattern(const std::string& pattern, std::string& prefix) {
+    if (pattern.empty() || pattern.back() != '%' || 
+        pattern.find('%') != pattern.length() - 1) {
+        return false;
+    }
+    prefix = pattern.substr(0, pattern.length() - 1);
+    return true;
+}
+
+// Convertir un texto completo a número sin reservar memoria. Solo se
+// aceptan decimales finitos: "nan", "inf", los hexadecimales y los espacios
+// iniciales (que strtod sí admite) son texto, porque un NaN no es igual,
+// menor ni mayor que nada y rompería las comparaciones y los órdenes.
+bool parseNumber(std::string_view text, double& number) {
+    const char* begin = text.data();
+    const char* end = begin + text.length();
+    // from_chars no admite el '+' inicial que sí aceptaba strtod
+    if (begin != end && *begin == '+' && end - begin > 1 && begin[1] != '-') {
+        ++begin;
+    }
+    if (begin == end) return false;
+    double value;
+    auto result = std::from_chars(begin, end, value, std::chars_format::general);
+    if (result.ec != std::errc() || result.ptr != end || !std::isfinite(value)) {
+        return false;
+    }
+    number = value;
+    return true;
+}
+
+bool parseNumber(const std::string& text, double& number) {
+    return parseNumber(std::string_view(text), number);
+}
+
+void appendCanonicalValue(std::string& out, const std::string& value) {
+    double number;
+    if (!parseNumber(value, number)) {
+        out += value;
+        return;
+    }
+    number += 0.0;  // Normalizar -0.0
+    // Representación más corta que vuelve a dar el mismo double
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), number);
+    out.append(text, result.ptr);
+}
+
+std::string canonicalValue(const std::string& value) {
+    std::string canonical;
+    appendCanonicalValue(canonical, value);
+    return canonical;
+}
+
+// Mezcla final de MurmurHash3: reparte la entropía en todos los bits
+static uint64_t mixHash(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+uint64_t hashNumber(double number) {
+    number += 0.0;  // Normalizar -0.0
+    uint64_t bits;
+    std::memcpy(&bits, &number, sizeof(bits));
+    return mixHash(bits);
+}
+
+uint64_t hashValue(const std::string& value) {
+    double number;
+    if (parseNumber(value, number)) {
+        return hashNumber(number);
+    }
+    // FNV-1a seguido de la mezcla final
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : value) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return mixHash(hash);
+}
+
+int compareValues(const std::string& a, const std::string& b) {
+    double num_a, num_b;
+    if (parseNumber(a, num_a) && parseNumber(b, num_b)) {
+        return (num_a < num_b) ? -1 : (num_a > num_b ? 1 : 0);
+    }
+    return a.compare(b);
+}
+
+int orderValues(const std::string& a, const std::string& b) {
+    double num_a, num_b;
+    bool a_numeric = parseNumber(a, num_a);
+    bool b_numeric = parseNumber(b, num_b);
+    if (a_numeric && b_numeric) {
+        return (num_a < num_b) ? -1 : (num_a > num_b ? 1 : 0);
+    }
+    if (a_numeric != b_numeric) {
+        return a_numeric ? -1 : 1;
+    }
+    return a.compare(b);
+}
+
+static bool applyOp(CompareOp op, int cmp) {
+    switch (op) {
+        case CompareOp::EQ: return cmp == 0;
+        case CompareOp::NE: return cmp != 0;
+        case CompareOp::LT: return cmp < 0;
+        case CompareOp::LE: return cmp <= 0;
+        case CompareOp::GT: return cmp > 0;
+        case CompareOp::GE: return cmp >= 0;
+        case CompareOp::PREFIX: return cmp == 0;
+    }
+    return false;
+}
+
+// ==================== COMPARISON ====================
+Comparison::Comparison() : op(CompareOp::EQ), is_numeric(false), numeric_value(0) {}
+
+Comparison::Comparison(const std::string& attr, CompareOp op_type, const std::string& val)
+    : attribute(attr), op(op_type), value(val), numeric_value(0) {
+    if (op == CompareOp::PREFIX) {
+        // Un prefijo se compara siempre como texto
+        if (!value.empty() && value.back() == '%') value.pop_back();
+        is_numeric = false;
+        return;
+    }
+    is_numeric = parseNumber(value, numeric_value);
+}
+
+// Misma comparación para cadenas del registro y para valores de una vista
+template <typename Text>
+static bool matchesText(const Comparison& comparison, const Text& record_value) {
+    int cmp;
+    double record_number;
+    if (comparison.op == CompareOp::PREFIX) {
+        cmp = (record_value.length() >= comparison.value.length())
+            ? record_value.compare(0, comparison.value.length(), comparison.value) : -1;
+    } else if (comparison.is_numeric && parseNumber(record_value, record_number)) {
+        cmp = (record_number < comparison.numeric_value) ? -1 
+            : (record_number > comparison.numeric_value ? 1 : 0);
+    } else {
+        cmp = record_value.compare(comparison.value);
+    }
+    return applyOp(comparison.op, cmp);
+}
+
+bool Comparison::matchesValue(const std::string& record_value) const {
+    return matchesText(*this, record_value);
+}
+
+bool Comparison::matchesValue(std::string_view record_value) const {
+    return matchesText(*this, record_value);
+}
+
+bool Comparison::matches(const Record& record) const {
+    auto it = record.data.find(attribute);
+    if (it == record.data.end()) {
+        return false;
+    }
+    return matchesValue(it->second);
+}
+
+std::string Comparison::toString() const {
+    std::string constant = (op == CompareOp::PREFIX) ? value + "%" : value;
+    return attribute + " " + compareOpToString(op) + " '" + constant + "'";
+}
+
+// ==================== PARSER ====================
+namespace {
+
+// Analizador descendente recursivo:
+//   expr    := term (OR term)*
+//   term    := factor (AND factor)*
+//   factor  := '(' expr ')' | IDENT op VALUE
+class ExpressionParser {
+public:
+    explicit ExpressionParser(const std::string& text) : input(text), pos(0) {}
+    
+    bool parse(Predicate::Node& node, std::string& error) {
+        if (!parseExpr(node, error)) return false;
+        skipSpaces();
+        if (pos != input.length()) {
+            error = "Unexpected input at position " + std::to_string(pos);
+            return false;
+        }
+        return true;
+    }
+    
+private:
+    const std::string& input;
+    size_t pos;
+    
+    void skipSpaces() {
+        while (pos < input.length() && std::isspace(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+    }
+    
+    // Reconocer una palabra clave (AND / OR) o su símbolo (&& / ||)
+    bool acceptKeyword(const std::string& keyword, const std::string& symbol) {
+        skipSpaces();
+        if (input.compare(pos, symbol.length(), symbol) == 0) {
+            pos += symbol.length();
+            return true;
+        }
+        if (pos + keyword.length() > input.length()) return false;
+        for (size_t i = 0; i < keyword.length(); ++i) {
+            if (std::toupper(static_cast<unsigned char>(input[pos + i])) != keyword[i]) {
+                return false;
+            }
+        }
+        size_t end = pos + keyword.length();
+        if (end < input.length() && 
+            (std::isalnum(static_cast<unsigned char>(input[end])) || input[end] == '_')) {
+            return false;
+        }
+        pos = end;
+        return true;
+    }
+    
+    bool parseExpr(Predicate::Node& node, std::string& error) {
+        Predicate::Node first;
+        if (!parseTerm(first, error)) return false;
+        if (!acceptKeyword("OR", "||")) {
+            node = first;
+            return true;
+        }
+        node.kind = Predicate::Kind::OR;
+        node.children.push_back(first);
+        do {
+            Predicate::Node next;
+            if (!parseTerm(next, error)) return false;
+            node.children.push_back(next);
+        } while (acceptKeyword("OR", "||"));
+        return true;
+    }
+    
+    bool parseTerm(Predicate::Node& node, std::string& error) {
+        Predicate::Node first;
+        if (!parseFactor(first, error)) return false;
+        if (!acceptKeyword("AND", "&&")) {
+            node = first;
+            return true;
+        }
+        node.kind = Predicate::Kind::AND;
+        node.children.push_back(first);
+        do {
+            Predicate::Node next;
+            if (!parseFactor(next, error)) return false;
+            node.children.push_back(next);
+        } while (acceptKeyword("AND", "&&"));
+        return true;
+    }
+    
+    bool parseFactor(Predicate::Node& node, std::string& error) {
+        skipSpaces();
+        if (pos < input.length() && input[pos] == '(') {
+            pos++;
+            if (!parseExpr(node, error)) return false;
+            skipSpaces();
+            if (pos >= input.length() || input[pos] != ')') {
+                error = "Expected ')' at position " + std::to_string(pos);
+                return false;
+            }
+            pos++;
+            return true;
+        }
+        
+        std::string attribute = readIdentifier();
+        if (attribute.empty()) {
+            error = "Expected attribute name at position " + std::to_string(pos);
+            return false;
+        }
+        
+        skipSpaces();
+        std::string op_text;
+        while (pos < input.length() && std::string("=!<>").find(input[pos]) != std::string::npos) {
+            op_text += input[pos++];
+        }
+        if (op_text.empty()) {
+            op_text = readIdentifier();  // Operador con nombre: LIKE
+        }
+        CompareOp op;
+        if (!parseCompareOp(op_text, op)) {
+            error = "Invalid operator '" + op_text + "' after " + attribute;
+            return false;
+        }
+        
+        std::string value;
+        if (!readValue(value, error)) return false;
+        std::string prefix;
+        if (op == CompareOp::PREFIX && !parseLikePattern(value, prefix)) {
+            error = "LIKE only supports prefix patterns such as 'abc%', got '" + value + "'";
+            return false;
+        }
+        
+        node.kind = Predicate::Kind::COMPARISON;
+        node.comparison = Comparison(attribute, op, value);
+        return true;
+    }
+    
+    std::string readIdentifier() {
+        skipSpaces();
+        size_t start = pos;
+        while (pos < input.length() && 
+               (std::isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) {
+            pos++;
+        }
+        return input.substr(start, pos - start);
+    }
+    
+    bool readValue(std::string& value, std::string& error) {
+        skipSpaces();
+        if (pos < input.length() && (input[pos] == '\'' || input[pos] == '"')) {
+            char quote = input[pos++];
+            size_t end = input.find(quote, pos);
+            if (end == std::string::npos) {
+                error = "Unterminated string literal";
+                return false;
+            }
+            value = input.substr(pos, end - pos);
+            pos = end + 1;
+            return true;
+        }
+        size_t start = pos;
+        while (pos < input.length() && !std::isspace(static_cast<unsigned char>(input[pos])) &&
+               input[pos] != '(' && input[pos] != ')') {
+            pos++;
+        }
+        value = input.substr(start, pos - start);
+        if (value.empty()) {
+            error = "Expected value at position " + std::to_string(pos);
+            return false;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+// ==================== PREDICATE ====================
+Predicate::Predicate() {
+    Node node;
+    node.kind = Kind::TRUE_CONST;
+    root = std::make_shared<const Node>(node);
+    compiled = compile(*root);
+}
+
+Predicate::Predicate(Node node) {
+    root = std::make_shared<const Node>(std::move(node));
+    compiled = compile(*root);
+}
+
+Predicate Predicate::comparison(const std::string& attribute, CompareOp op, 
+                                const std::string& value) {
+    Node node;
+    node.kind = Kind::COMPARISON;
+    node.comparison = Comparison(attribute, op, value);
+    return Predicate(node);
+}
+
+bool Predicate::parse(const std::string& expression, Predicate& result, std::string& error) {
+    Node node;
+    ExpressionParser parser(expression);
+    if (!parser.parse(node, error)) {
+        return false;
+    }
+    result = Predicate(node);
+    return true;
+}
+
+static bool evaluateNode(const Predicate::Node& node, const RecordView& view) {
+    switch (node.kind) {
+        case Predicate::Kind::TRUE_CONST:
+            return true;
+        case Predicate::Kind::COMPARISON: {
+            std::string_view value;
+            return view.get(node.comparison.attribute, value) && 
+                   node.comparison.matchesValue(value);
+        }
+        case Predicate::Kind::AND:
+            for (const auto& child : node.children) {
+                if (!evaluateNode(child, view)) return false;
+            }
+            return true;
+        case Predicate::Kind::OR:
+            for (const auto& child : node.children) {
+                if (evaluateNode(child, view)) return true;
+            }
+            return false;
+    }
+    return false;
+}
+
+bool Predicate::evaluate(const RecordView& view) const {
+    return evaluateNode(*root, view);
+}
+
+std::function<bool(const Record&)> Predicate::compile(const Node& node) {
+    // Los nodos viven en el árbol compartido 'root', por lo que las
+    // closures pueden referenciarlos sin copiarlos
+    switch (node.kind) {
+        case Kind::TRUE_CONST:
+            return [](const Record&) { return true; };
+        case Kind::COMPARISON: {
+            const Comparison* cmp = &node.comparison;
+            return [cmp](const Record& record) { return cmp->matches(record); };
+        }
+        case Kind::AND:
+        case Kind::OR: {
+            std::vector<std::function<bool(const Record&)>> parts;
+            for (const auto& child : node.children) {
+                parts.push_back(compile(child));
+            }
+            if (node.kind == Kind::AND) {
+                return [parts](const Record& record) {
+                    for (const auto& part : parts) {
+                        if (!part(record)) return false;
+                    }
+                    return true;
+                };
+            }
+            return [parts](const Record& record) {
+                for (const auto& part : parts) {
+                    if (part(record)) return true;
+                }
+                return false;
+            };
+        }
+    }
+    return [](const Record&) { return false; };
+}
+
+std::vector<Comparison> Predicate::getConjuncts() const {
+    std::vector<Comparison> conjuncts;
+    if (root->kind == Kind::COMPARISON) {
+        conjuncts.push_back(root->comparison);
+    } else if (root->kind == Kind::AND) {
+        for (const auto& child : root->children) {
+            if (child.kind == Kind::COMPARISON) {
+                conjuncts.push_back(child.comparison);
+            }
+        }
+    }
+    return conjuncts;
+}
+
+static void collectAttributes(const Predicate::Node& node, std::set<std::string>& attributes) {
+    if (node.kind == Predicate::Kind::COMPARISON) {
+        attributes.insert(node.comparison.attribute);
+    }
+    for (const auto& child : node.children) {
+        collectAttributes(child, attributes);
+    }
+}
+
+std::set<std::string> Predicate::getAttributes() const {
+    std::set<std::string> attributes;
+    collectAttributes(*root, attributes);
+    return attributes;
+}
+
+static std::string nodeToString(const Predicate::Node& node, bool canonical) {
+    switch (node.kind) {
+        case Predicate::Kind::TRUE_CONST:
+            return "TRUE";
+        case Predicate::Kind::COMPARISON:
+            return node.comparison.toString();
+        case Predicate::Kind::AND:
+        case Predicate::Kind::OR: {
+            std::vector<std::string> parts;
+            for (const auto& child : node.children) {
+                parts.push_back(nodeToString(child, canonical));
+            }
+            // AND y OR son conmutativos: ordenar los operandos da la misma
+            // forma a predicados equivalentes escritos en otro orden
+            if (canonical) {
+                std::sort(parts.begin(), parts.end());
+            }
+            std::string joiner = (node.kind == Predicate::Kind::AND) ? " AND " : " OR ";
+            std::string result = "(";
+            for (size_t i = 0; i < parts.size(); ++i) {
+                if (i > 0) result += joiner;
+                result += parts[i];
+            }
+            return result + ")";
+        }
+    }
+    return "";
+}
+
+std::string Predicate::toString() const {
+    return nodeToString(*root, false);
+}
+
+std::string Predicate::toCanonicalString() const {
+    return nodeToString(*root, true);
+}
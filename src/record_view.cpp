@@ -0,0 +1,62 @@
+#include "record_view.h"
+
+// ==================== RECORD VIEW ====================
+RecordView::RecordView(const Record& resident) : record(&resident), block(nullptr), row(0) {}
+
+RecordView::RecordView(const EncodedBlock& encoded, size_t row_index)
+    : record(nullptr), block(&encoded), row(row_index) {}
+
+int RecordView::getId() const {
+    return (record != nullptr) ? record->record_id : block->getRecordId(row);
+}
+
+bool RecordView::isDeleted() const {
+    return (record != nullptr) ? record->is_deleted : block->isDeleted(row);
+}
+
+bool RecordView::isEncoded() const {
+    return record == nullptr;
+}
+
+bool RecordView::get(const std::string& attribute, std::string_view& value) const {
+    if (record != nullptr) {
+        auto it = record->data.find(attribute);
+        if (it == record->data.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+    int column = block->findColumn(attribute);
+    return column >= 0 && block->getValue(static_cast<size_t>(column), row, value);
+}
+
+void RecordView::forEachField(
+        const std::function<void(std::string_view, std::string_view)>& visitor) const {
+    if (record != nullptr) {
+        for (const auto& pair : record->data) {
+            visitor(pair.first, pair.second);
+        }
+        return;
+    }
+    // Las columnas del formato están ordenadas por nombre, como el mapa de Record
+    std::string_view value;
+    for (size_t column = 0; column < block->getColumnCount(); ++column) {
+        if (block->getValue(column, row, value)) {
+            visitor(block->getColumnName(column), value);
+        }
+    }
+}
+
+Record RecordView::materialize() const {
+    if (record != nullptr) {
+        return *record;
+    }
+    Record copy;
+    copy.record_id = getId();
+    copy.is_deleted = isDeleted();
+    forEachField([&copy](std::string_view name, std::string_view value) {
+        copy.data.emplace(std::string(name), std::string(value));
+    });
+    return copy;
+}
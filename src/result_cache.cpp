@@ -0,0 +1,131 @@
+#include "result_cache.h"
+#include <iterator>
+
+// ==================== RESULT CACHE ====================
+ResultCache::ResultCache(size_t capacity_bytes)
+    : max_bytes(capacity_bytes), used_bytes(0), hits(0), misses(0), invalidations(0) {}
+
+void ResultCache::setCapacity(size_t capacity_bytes) {
+    max_bytes = capacity_bytes;
+    while (used_bytes > max_bytes && !lru_list.empty()) {
+        erase(entries.find(lru_list.back()));
+    }
+}
+
+bool ResultCache::isEnabled() const {
+    return max_bytes > 0;
+}
+
+std::string ResultCache::makeKey(const std::string& table, const std::string& predicate) {
+    return table + "|" + predicate;
+}
+
+void ResultCache::erase(std::unordered_map<std::string, Entry>::iterator it) {
+    used_bytes -= it->second.bytes;
+    lru_list.erase(it->second.lru_position);
+    entries.erase(it);
+}
+
+const std::vector<int>* ResultCache::lookup(const std::string& key) {
+    if (!isEnabled()) return nullptr;
+    
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    lru_list.splice(lru_list.begin(), lru_list, it->second.lru_position);
+    return &it->second.record_ids;
+}
+
+void ResultCache::insert(const std::string& key, const std::string& table,
+                         const std::set<std::string>& attributes, 
+                         const std::vector<int>& record_ids) {
+    if (!isEnabled()) return;
+    
+    auto existing = entries.find(key);
+    if (existing != entries.end()) {
+        erase(existing);
+    }
+    
+    size_t bytes = 2 * key.size() + record_ids.size() * sizeof(int) + sizeof(Entry) + 
+                   4 * sizeof(void*);
+    for (const auto& attribute : attributes) {
+        bytes += attribute.size() + 4 * sizeof(void*);
+    }
+    if (bytes > max_bytes) return;  // Un resultado mayor que toda la caché no se guarda
+    
+    while (used_bytes + bytes > max_bytes && !lru_list.empty()) {
+        erase(entries.find(lru_list.back()));
+    }
+    
+    lru_list.push_front(key);
+    Entry entry;
+    entry.table = table;
+    entry.attributes = attributes;
+    entry.record_ids = record_ids;
+    entry.bytes = bytes;
+    entry.lru_position = lru_list.begin();
+    entries.emplace(key, std::move(entry));
+    used_bytes += bytes;
+}
+
+bool ResultCache::dependsOn(const Entry& entry, const std::string& table,
+                            const std::set<std::string>& attributes) const {
+    if (!entry.table.empty() && entry.table != table) {
+        return false;
+    }
+    if (entry.attributes.empty()) {
+        return true;
+    }
+    // Un registro sin ninguno de los atributos del predicado no puede cumplirlo
+    for (const auto& attribute : attributes) {
+        if (entry.attributes.count(attribute)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResultCache::invalidate(const std::string& table, const std::set<std::string>& attributes) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (dependsOn(it->second, table, attributes)) {
+            auto next = std::next(it);
+            erase(it);
+            invalidations++;
+            it = next;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ResultCache::invalidate(const std::string& table, const Record& record) {
+    if (entries.empty()) return;
+    std::set<std::string> attributes;
+    for (const auto& pair : record.data) {
+        attributes.insert(pair.first);
+    }
+    invalidate(table, attributes);
+}
+
+void ResultCache::clear() {
+    entries.clear();
+    lru_list.clear();
+    used_bytes = 0;
+}
+
+size_t ResultCache::getMemoryUsage() const {
+    return used_bytes + entries.bucket_count() * sizeof(void*);
+}
+
+void ResultCache::print() const {
+    long long lookups = hits + misses;
+    std::cout << "Result cache: " << entries.size() << " entries, " << used_bytes << "/" 
+              << max_bytes << " bytes, " << hits << " hits, " << misses << " misses";
+    if (lookups > 0) {
+        std::cout << " (hit ratio " << 100.0 * hits / lookups << "%)";
+    }
+    std::cout << ", " << invalidations << " invalidations\n";
+}
@@ -0,0 +1,417 @@
+#include "server.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using protocol::Opcode;
+using protocol::Request;
+using protocol::Response;
+using protocol::Status;
+
+// ==================== SGBD SERVER ====================
+SGBDServer::Connection::Connection(int socket_fd)
+    : fd(socket_fd), input_offset(0), output_offset(0), events(0), closing(false) {}
+
+SGBDServer::SGBDServer(SGBD& database, const std::string& path, bool verbose_output)
+    : system(database), socket_path(path), listen_fd(-1), epoll_fd(-1),
+      verbose(verbose_output), running(false), requests_served(0), batches_executed(0),
+      largest_batch(0), inserts_coalesced(0), connections_accepted(0), protocol_errors(0) {}
+
+SGBDServer::~SGBDServer() {
+    for (auto& pair : connections) {
+        close(pair.first);
+    }
+    connections.clear();
+
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        unlink(socket_path.c_str());
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+    }
+}
+
+bool SGBDServer::start(std::string& error) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+        error = "Invalid socket path '" + socket_path + "'";
+        return false;
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        error = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    // Un socket que quedó de una ejecución anterior impediría el bind
+    unlink(socket_path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd, SOMAXCONN) < 0) {
+        error = std::string("bind/listen on ") + socket_path + ": " + std::strerror(errno);
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        error = std::string("epoll_create1: ") + std::strerror(errno);
+        return false;
+    }
+
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) < 0) {
+        error = std::string("epoll_ctl: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void SGBDServer::stop() {
+    running = false;
+}
+
+void SGBDServer::run() {
+    running = true;
+    // Los mensajes por operación del SGBD se descartan salvo en modo verbose.
+    // El modo es de la instancia: no afecta al resto de la salida del proceso.
+    system.setVerbose(verbose);
+    std::vector<epoll_event> events(MAX_EVENTS);
+    std::vector<PendingRequest> batch;
+    std::vector<int> touched;
+
+    while (running) {
+        // El tiempo de espera acotado permite notar stop() aunque no haya tráfico
+        int ready = epoll_wait(epoll_fd, events.data(), MAX_EVENTS, 500);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            std::cout << "Error: epoll_wait: " << std::strerror(errno) << "\n";
+            break;
+        }
+
+        batch.clear();
+        touched.clear();
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listen_fd) {
+                acceptConnections();
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end()) continue;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                readConnection(it->second, batch);
+            }
+            touched.push_back(fd);
+        }
+
+        executeBatch(batch);
+
+        // Una escritura por conexión con todas las respuestas del lote
+        for (int fd : touched) {
+            auto it = connections.find(fd);
+            if (it == connections.end()) continue;
+            Connection& connection = it->second;
+            flushConnection(connection);
+            if (connection.closing && connection.output_offset == connection.output.size()) {
+                closeConnection(fd);
+            } else {
+                updateEvents(connection);
+            }
+        }
+    }
+    system.setVerbose(true);
+}
+
+void SGBDServer::acceptConnections() {
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cout << "Error: accept: " << std::strerror(errno) << "\n";
+            }
+            return;
+        }
+
+        Connection& connection = connections.emplace(fd, Connection(fd)).first->second;
+        connections_accepted++;
+        updateEvents(connection);
+    }
+}
+
+void SGBDServer::readConnection(Connection& connection, std::vector<PendingRequest>& batch) {
+    char chunk[64 * 1024];
+    while (true) {
+        ssize_t received = recv(connection.fd, chunk, sizeof(chunk), 0);
+        if (received > 0) {
+            connection.input.append(chunk, static_cast<size_t>(received));
+            continue;
+        }
+        if (received < 0 && errno == EINTR) continue;
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+        // Fin de flujo o error: se responde a lo ya recibido y se cierra
+        connection.closing = true;
+        break;
+    }
+
+    const char* payload = nullptr;
+    uint32_t length = 0;
+    int status;
+    while ((status = protocol::nextFrame(connection.input, connection.input_offset,
+                                         payload, length)) == 1) {
+        PendingRequest pending;
+        pending.fd = connection.fd;
+        // Una trama mal formada pero bien delimitada se responde con un error
+        // en su turno y la conexión sigue con la siguiente
+        if (!protocol::decodeRequest(payload, length, pending.request, pending.error)) {
+            protocol_errors++;
+        }
+        batch.push_back(std::move(pending));
+    }
+
+    if (status < 0) {
+        // Longitud imposible: el flujo ya no se puede resincronizar
+        protocol_errors++;
+        connection.closing = true;
+        connection.input.clear();
+        connection.input_offset = 0;
+    } else if (connection.input_offset == connection.input.size()) {
+        connection.input.clear();
+        connection.input_offset = 0;
+    } else if (connection.input_offset > 64 * 1024) {
+        connection.input.erase(0, connection.input_offset);
+        connection.input_offset = 0;
+    }
+}
+
+void SGBDServer::flushConnection(Connection& connection) {
+    while (connection.output_offset < connection.output.size()) {
+        ssize_t sent = send(connection.fd, connection.output.data() + connection.output_offset,
+                            connection.output.size() - connection.output_offset, MSG_NOSIGNAL);
+        if (sent > 0) {
+            connection.output_offset += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+
+        // El cliente ya no lee: se descarta lo pendiente
+        connection.closing = true;
+        connection.output.clear();
+        connection.output_offset = 0;
+        return;
+    }
+    connection.output.clear();
+    connection.output_offset = 0;
+}
+
+void SGBDServer::updateEvents(Connection& connection) {
+    size_t pending = connection.output.size() - connection.output_offset;
+    uint32_t desired = 0;
+    // Con demasiadas respuestas sin leer se deja de aceptar peticiones nuevas
+    if (!connection.closing && pending < MAX_PENDING_OUTPUT) {
+        desired |= EPOLLIN;
+    }
+    if (pending > 0) {
+        desired |= EPOLLOUT;
+    }
+    if (desired == connection.events) return;
+
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = desired;
+    event.data.fd = connection.fd;
+    int operation = (connection.events == 0) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    if (desired == 0) {
+        operation = EPOLL_CTL_DEL;
+    }
+    epoll_ctl(epoll_fd, operation, connection.fd, &event);
+    connection.events = desired;
+}
+
+void SGBDServer::closeConnection(int fd) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections.erase(fd);
+}
+
+void SGBDServer::executeBatch(std::vector<PendingRequest>& batch) {
+    if (batch.empty()) return;
+
+    batches_executed++;
+    requests_served += static_cast<long long>(batch.size());
+    largest_batch = std::max(largest_batch, static_cast<long long>(batch.size()));
+
+    size_t i = 0;
+    while (i < batch.size()) {
+        const Request& request = batch[i].request;
+        if (request.opcode == Opcode::INSERT && batch[i].error.empty()) {
+            // Agrupar las inserciones consecutivas en la misma tabla. El
+            // orden relativo con el resto de peticiones no cambia.
+            size_t end = i + 1;
+            while (end < batch.size() && batch[end].request.opcode == Opcode::INSERT &&
+                   batch[end].error.empty() && batch[end].request.table == request.table) {
+                end++;
+            }
+            if (end - i > 1) {
+                executeInserts(batch, i, end);
+                i = end;
+                continue;
+            }
+        }
+
+        auto it = connections.find(batch[i].fd);
+        if (it != connections.end()) {
+            if (batch[i].error.empty()) {
+                executeRequest(request, it->second.output);
+            } else {
+                Response response;
+                response.request_id = request.request_id;
+                response.status = Status::ERROR;
+                response.message = batch[i].error;
+                protocol::encodeResponse(response, {}, it->second.output);
+            }
+        }
+        i++;
+    }
+}
+
+void SGBDServer::executeInserts(std::vector<PendingRequest>& batch, size_t begin, size_t end) {
+    std::string table = batch[begin].request.table.empty() ? "default" : batch[begin].request.table;
+
+    std::vector<Record> records;
+    records.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        Request& request = batch[i].request;
+        int record_id = (request.record_id != 0) ? static_cast<int>(request.record_id)
+                                                 : system.allocateRecordId();
+        records.emplace_back(request.fields, record_id);
+    }
+
+    std::vector<bool> stored;
+    system.addRecords(records, table, &stored);
+    inserts_coalesced += static_cast<long long>(end - begin);
+
+    for (size_t i = begin; i < end; ++i) {
+        Response response;
+        response.request_id = batch[i].request.request_id;
+        response.record_id = static_cast<uint32_t>(records[i - begin].record_id);
+        response.count = stored[i - begin] ? 1 : 0;
+        if (!stored[i - begin]) {
+            response.status = Status::ERROR;
+            response.message = "Could not store record";
+        }
+
+        auto it = connections.find(batch[i].fd);
+        if (it != connections.end()) {
+            protocol::encodeResponse(response, {}, it->second.output);
+        }
+    }
+}
+
+void SGBDServer::executeRequest(const Request& request, std::string& output) {
+    Response response;
+    response.request_id = request.request_id;
+    std::vector<Record> results;   // Copias que respaldan a 'records'
+    std::vector<const Record*> records;
+
+    switch (request.opcode) {
+        case Opcode::PING:
+            break;
+
+        case Opcode::INSERT: {
+            int record_id = (request.record_id != 0) ? static_cast<int>(request.record_id)
+                                                     : system.allocateRecordId();
+            response.record_id = static_cast<uint32_t>(record_id);
+            std::string table = request.table.empty() ? "default" : request.table;
+            if (system.addRecord(Record(request.fields, record_id), table)) {
+                response.count = 1;
+            } else {
+                response.status = Status::ERROR;
+                response.message = "Could not store record";
+            }
+            break;
+        }
+
+        case Opcode::QUERY:
+        case Opcode::UPDATE: {
+            Predicate predicate;
+            std::string error;
+            if (!Predicate::parse(request.text, predicate, error)) {
+                response.status = Status::ERROR;
+                response.message = "Invalid expression: " + error;
+                break;
+            }
+
+            if (request.opcode == Opcode::UPDATE) {
+                response.count = static_cast<uint32_t>(
+                    system.updateRecords(predicate, request.fields, request.table));
+                break;
+            }
+
+            results = system.query(predicate, request.table);
+            response.count = static_cast<uint32_t>(results.size());
+            size_t limit = (request.limit == 0) ? results.size()
+                                                : std::min<size_t>(request.limit, results.size());
+            // Sin límite, el resultado puede superar lo que admite una trama:
+            // se envían las filas que caben (el resto de campos es pequeño)
+            size_t frame_bytes = MAX_RESPONSE_HEADER_BYTES;
+            for (size_t i = 0; i < limit; ++i) {
+                frame_bytes += protocol::Writer::recordSize(results[i]);
+                if (frame_bytes > protocol::MAX_FRAME_BYTES) break;
+                records.push_back(&results[i]);
+            }
+            break;
+        }
+
+        case Opcode::GET: {
+            results.emplace_back();
+            if (!system.findRecord(static_cast<int>(request.record_id), results.back())) {
+                response.status = Status::NOT_FOUND;
+            } else {
+                response.count = 1;
+                records.push_back(&results.back());
+            }
+            break;
+        }
+
+        case Opcode::DELETE:
+            if (system.deleteRecord(static_cast<int>(request.record_id))) {
+                response.count = 1;
+            } else {
+                response.status = Status::NOT_FOUND;
+            }
+            break;
+    }
+
+    protocol::encodeResponse(response, records, output);
+}
+
+void SGBDServer::printStats() const {
+    std::cout << "=== Server Statistics ===\n";
+    std::cout << "Connections accepted: " << connections_accepted
+              << " (" << connections.size() << " open)\n";
+    std::cout << "Requests served: " << requests_served << " in " << batches_executed
+              << " batches";
+    if (batches_executed > 0) {
+        std::cout << " (average " << static_cast<double>(requests_served) / batches_executed
+                  << ", largest " << largest_batch << ")";
+    }
+    std::cout << "\n";
+    std::cout << "Inserts coalesced into batch inserts: " << inserts_coalesced << "\n";
+    std::cout << "Protocol errors: " << protocol_errors << "\n";
+}
@@ -2,28 +2,77 @@
 
 // ==================== SGBD IMPLEMENTATION ====================
 SGBD::SGBD(int platters, int surfaces, int tracks, int sectors, 
-     int sector_cap, int rec_per_block, int buffer_size)
-    : disk_manager(platters, surfaces, tracks, sectors, sector_cap, rec_per_block, buffer_size),
-      next_record_id(1) {
+     int sector_cap, size_t buffer_bytes, int block_size, double fill)
+    : disk_manager(platters, surfaces, tracks, sectors, sector_cap, 
+                   buffer_bytes, block_size),
+      next_record_id(1), next_block_id(1), fill_factor(fill), output(std::cout.rdbuf()),
+      background_writer(disk_manager.getBufferManager(), latch),
+      bloom_probes(0), bloom_skips(0), bloom_false_positives(0),
+      view_buffers_busy(false), view_rows(0), view_resident_blocks(0), 
+      view_encoded_blocks(0), view_columns_decoded(0) {
     
     std::cout << "\n=== SGBD System Initialized ===\n";
+    std::cout << "Block fill factor: " << fill_factor << "\n";
     disk_manager.printDiskStatus();
+    disk_manager.setOutput(output);
 }
 
-bool SGBD::loadFromCSV(const std::string& filename) {
+SGBD::~SGBD() {
+    // El escritor debe parar antes de que desaparezcan los bloques. Lo que
+    // ya volcó no se vuelve a escribir, lo que acorta el cierre.
+    background_writer.stop();
+    
+    // Volcar los bloques sucios antes de liberar la memoria de los bloques
+    disk_manager.getBufferManager().flushAllBlocks();
+    disk_manager.getBufferManager().clear();
+    // 'output' se destruye antes que el disco
+    disk_manager.setOutput(std::cout);
+    
+    for (auto& pair : all_blocks) {
+        delete pair.second;
+    }
+}
+
+void SGBD::setVerbose(bool verbose) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    // Sin streambuf el stream descarta lo que se escribe en él
+    output.rdbuf(verbose ? std::cout.rdbuf() : nullptr);
+}
+
+bool SGBD::createTable(const std::string& name, const std::vector<std::string>& schema) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    if (catalog.createTable(name, schema) == nullptr) {
+        output << "Table " << name << " already exists\n";
+        return false;
+    }
+    output << "Table " << name << " created\n";
+    return true;
+}
+
+bool SGBD::loadFromCSV(const std::string& filename, const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
     std::ifstream file(filename);
     if (!file.is_open()) {
-        std::cout << "Error: Cannot open file " << filename << std::endl;
+        output << "Error: Cannot open file " << filename << std::endl;
         return false;
     }
     
+    // Sin nombre explícito, la tabla se llama como el fichero sin ruta ni extensión
+    std::string table = table_name;
+    if (table.empty()) {
+        size_t slash = filename.find_last_of("/\\");
+        table = (slash == std::string::npos) ? filename : filename.substr(slash + 1);
+        size_t dot = table.find_last_of('.');
+        if (dot != std::string::npos) table = table.substr(0, dot);
+    }
+    
     Timer timer;
     timer.start();
     
     std::string line;
     std::vector<std::string> headers;
     bool first_line = true;
-    int records_loaded = 0;
+    std::vector<Record> batch;
     
     while (std::getline(file, line)) {
         std::istringstream iss(line);
@@ -41,6 +90,9 @@ bool SGBD::loadFromCSV(const std::string& filename) {
         if (first_line) {
             headers = tokens;
             first_line = false;
+            if (!catalog.hasTable(table)) {
+                catalog.createTable(table, headers);
+            }
             continue;
         }
         
@@ -50,152 +102,1426 @@ bool SGBD::loadFromCSV(const std::string& filename) {
             record_data[headers[i]] = tokens[i];
         }
         
-        Record new_record(record_data, next_record_id++);
-        if (addRecord(new_record)) {
-            records_loaded++;
-        }
+        batch.emplace_back(record_data, next_record_id++);
     }
     
+    // Los registros se insertan en un único lote
+    int records_loaded = addRecords(batch, table);
+    
     double elapsed_time = timer.getElapsedTime();
-    std::cout << "Loaded " << records_loaded << " records from " << filename 
-              << " in " << elapsed_time << " ms\n";
+    output << "Loaded " << records_loaded << " records from " << filename 
+           << " into table " << table << " in " << elapsed_time << " ms\n";
     
     file.close();
     return true;
 }
 
-bool SGBD::addRecord(const Record& record) {
-    Timer timer;
-    timer.start();
+Block* SGBD::createBlock(Table* table, int min_bytes) {
+    // La página usa el tamaño de bloque del disco, salvo que el registro
+    // no quepa en ella respetando el fill factor
+    int capacity = std::max(disk_manager.getBlockSize(), 
+                            static_cast<int>(min_bytes / fill_factor) + 1);
+    
+    while (all_blocks.count(next_block_id)) {
+        next_block_id++;
+    }
+    Block* block = new Block(next_block_id++, capacity, fill_factor);
+    
+    // Almacenar el bloque en el disco
+    if (!disk_manager.storeBlock(block)) {
+        delete block;
+        return nullptr;
+    }
+    
+    attachBlock(table, block);
+    return block;
+}
+
+Table* SGBD::getOrCreateTable(const std::string& table_name) {
+    Table* table = catalog.getTable(table_name);
+    if (table == nullptr) {
+        table = catalog.createTable(table_name, std::vector<std::string>());
+    }
+    return table;
+}
+
+void SGBD::attachBlock(Table* table, Block* block) {
+    block->table_name = table->name;
+    for (const auto& pair : table->bloom_columns) {
+        block->enableBloomFilter(pair.first, pair.second);
+    }
+    all_blocks[block->block_id] = block;
+    table->block_ids.push_back(block->block_id);
     
-    // Buscar un bloque con espacio disponible
+    for (const auto& record : block->records) {
+        table->extendSchema(record);
+        result_cache.invalidate(table->name, record);
+        if (!record.is_deleted) {
+            table->addToColumnStats(record);
+            table->stats.row_count++;
+            table->stats.data_bytes += Block::encodedSize(record);
+        } else {
+            table->stats.deleted_count++;
+        }
+    }
+    
+    // Añadir al buffer manager, que contabiliza su memoria
+    disk_manager.getBufferManager().addBlock(block);
+}
+
+std::vector<Block*> SGBD::getTableBlocks(const std::string& table_name) {
+    std::vector<Block*> blocks;
+    if (table_name.empty()) {
+        blocks.reserve(all_blocks.size());
+        for (auto& pair : all_blocks) {
+            blocks.push_back(pair.second);
+        }
+        return blocks;
+    }
+    
+    const Table* table = catalog.getTable(table_name);
+    if (table == nullptr) {
+        output << "Error: Table " << table_name << " does not exist\n";
+        return blocks;
+    }
+    blocks.reserve(table->block_ids.size());
+    for (int block_id : table->block_ids) {
+        auto it = all_blocks.find(block_id);
+        if (it != all_blocks.end()) {
+            blocks.push_back(it->second);
+        }
+    }
+    return blocks;
+}
+
+Block* SGBD::fetchBlock(Block* block) {
+    return disk_manager.getBufferManager().fetchBlock(block);
+}
+
+std::vector<Block*> SGBD::pruneBlocks(const std::vector<Block*>& blocks, 
+                                      const Predicate& predicate, int& skipped,
+                                      std::vector<bool>* bloom_consulted) {
+    skipped = 0;
+    if (predicate.isTrue()) {
+        if (bloom_consulted != nullptr) {
+            bloom_consulted->assign(blocks.size(), false);
+        }
+        return blocks;
+    }
+    
+    std::vector<Block*> candidates;
+    candidates.reserve(blocks.size());
+    for (Block* block : blocks) {
+        if (!block->mayMatch(predicate)) {
+            skipped++;
+            continue;
+        }
+        bool consulted;
+        bool may_match = block->bloomMayMatch(predicate, consulted);
+        if (consulted) {
+            bloom_probes++;
+        }
+        if (!may_match) {
+            bloom_skips++;
+            skipped++;
+            continue;
+        }
+        candidates.push_back(block);
+        if (bloom_consulted != nullptr) {
+            bloom_consulted->push_back(consulted);
+        }
+    }
+    return candidates;
+}
+
+Block* SGBD::placeRecord(Table* table, const Record& record, bool* heap_full) {
+    // Buscar en el heap de la tabla un bloque con espacio para el registro
+    // codificado, empezando por el último bloque usado para insertar
+    int required_bytes = Block::encodedSize(record);
     Block* target_block = nullptr;
     
-    for (auto& pair : all_blocks) {
-        if (pair.second->hasSpace()) {
-            target_block = pair.second;
-            break;
+    auto hint = all_blocks.find(table->insert_block_id);
+    if (hint != all_blocks.end() && hint->second->hasSpace(required_bytes)) {
+        target_block = hint->second;
+    } else if (heap_full == nullptr || !*heap_full) {
+        for (int block_id : table->block_ids) {
+            Block* block = all_blocks[block_id];
+            if (block->hasSpace(required_bytes)) {
+                target_block = block;
+                break;
+            }
+        }
+        // En un lote, si el heap ya no tenía hueco no se vuelve a recorrer
+        if (target_block == nullptr && heap_full != nullptr) {
+            *heap_full = true;
         }
     }
     
     // Si no hay bloque disponible, crear uno nuevo
     if (target_block == nullptr) {
-        target_block = new Block(static_cast<int>(all_blocks.size()) + 1, 5); // 5 registros por bloque
-        all_blocks[target_block->block_id] = target_block;
+        target_block = createBlock(table, required_bytes);
+        if (target_block == nullptr) {
+            return nullptr;
+        }
+    }
+    table->insert_block_id = target_block->block_id;
+    
+    // El bloque elegido puede estar descargado: traer sus registros
+    if (fetchBlock(target_block) == nullptr || !target_block->addRecord(record)) {
+        return nullptr;
+    }
+    disk_manager.getBufferManager().updateUsage(target_block);
+    indexRecord(record, target_block->block_id);
+    table->extendSchema(record);
+    table->addToColumnStats(record);
+    table->stats.row_count++;
+    table->stats.data_bytes += required_bytes;
+    return target_block;
+}
+
+int SGBD::allocateRecordId() {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    restoreDeferred();
+    // Saltar los IDs que ya eligió el llamador en inserciones explícitas
+    while (record_block.count(next_record_id) > 0) {
+        next_record_id++;
+    }
+    return next_record_id++;
+}
+
+bool SGBD::addRecord(const Record& record, const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    Timer timer;
+    timer.start();
+    
+    Table* table = getOrCreateTable(table_name);
+    Block* target_block = placeRecord(table, record);
+    if (target_block != nullptr) {
+        result_cache.invalidate(table->name, record);
+    }
+    
+    if (target_block != nullptr) {
+        double elapsed_time = timer.getElapsedTime();
+        output << "Record " << record.record_id << " added successfully in " 
+               << elapsed_time << " ms\n";
+        output << "Location: ";
+        target_block->location.print(output);
+    }
+    
+    return target_block != nullptr;
+}
+
+int SGBD::addRecords(const std::vector<Record>& batch, const std::string& table_name,
+                     std::vector<bool>* stored) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    Timer timer;
+    timer.start();
+    
+    // La tabla se resuelve una vez y cada registro continúa en el bloque de
+    // inserción actual; solo se busca otro bloque cuando éste se llena
+    Table* table = getOrCreateTable(table_name);
+    size_t blocks_before = table->block_ids.size();
+    record_block.reserve(record_block.size() + batch.size());
+    
+    int inserted = 0;
+    bool heap_full = false;
+    std::set<std::string> written_attributes;
+    if (stored != nullptr) {
+        stored->assign(batch.size(), false);
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const Record& record = batch[i];
+        if (placeRecord(table, record, &heap_full) == nullptr) {
+            output << "Error: Could not store record " << record.record_id << "\n";
+            continue;
+        }
+        if (stored != nullptr) {
+            (*stored)[i] = true;
+        }
+        for (const auto& pair : record.data) {
+            written_attributes.insert(pair.first);
+        }
+        inserted++;
+    }
+    // Una sola invalidación de la caché para todo el lote
+    if (inserted > 0) {
+        result_cache.invalidate(table->name, written_attributes);
+    }
+    
+    double elapsed_time = timer.getElapsedTime();
+    output << "Batch of " << inserted << " records added to table " << table->name 
+           << " in " << elapsed_time << " ms (" 
+           << (table->block_ids.size() - blocks_before) << " new blocks)\n";
+    return inserted;
+}
+
+int SGBD::updateRecords(const std::string& where, 
+                        const std::map<std::string, std::string>& assignments,
+                        const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    Predicate predicate;
+    std::string error;
+    if (!where.empty() && !Predicate::parse(where, predicate, error)) {
+        output << "Error: Invalid query expression: " << error << "\n";
+        return 0;
+    }
+    return updateRecords(predicate, assignments, table_name);
+}
+
+int SGBD::updateRecords(const Predicate& predicate, 
+                        const std::map<std::string, std::string>& assignments,
+                        const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    Timer timer;
+    timer.start();
+    
+    // Reubicar registros cambia los bloques: se trabaja con los IDs
+    std::vector<int> record_ids;
+    executeQuery(predicate, table_name, [&record_ids](const Record& record) {
+        record_ids.push_back(record.record_id);
+    });
+    
+    int in_place = 0;
+    int relocated = 0;
+    std::set<std::string> updated_tables;
+    for (int record_id : record_ids) {
+        Block* block = findBlockOfRecord(record_id);
+        Record* current = (block != nullptr) ? block->findRecord(record_id) : nullptr;
+        if (current == nullptr) continue;
+        Table* table = catalog.getTable(block->table_name);
+        
+        // Reubicar puede cargar otros bloques: el original no debe desalojarse
+        BlockPin pin(disk_manager.getBufferManager(), block);
         
-        // Almacenar el bloque en el disco
-        if (!disk_manager.storeBlock(target_block)) {
-            delete target_block;
-            all_blocks.erase(target_block->block_id);
-            return false;
+        updated_tables.insert(block->table_name);
+        Record updated = *current;
+        for (const auto& assignment : assignments) {
+            updated.data[assignment.first] = assignment.second;
         }
         
-        // Añadir al buffer manager
-        disk_manager.getBufferManager().addBlock(target_block);
+        // Retirar los valores antiguos de índices y estadísticas
+        unindexRecord(*current);
+        if (table != nullptr) {
+            table->removeFromColumnStats(*current);
+            table->stats.row_count--;
+            table->stats.data_bytes -= Block::encodedSize(*current);
+        }
+        
+        if (block->updateRecord(updated)) {
+            in_place++;
+            disk_manager.getBufferManager().updateUsage(block);
+            indexRecord(updated, block->block_id);
+            if (table != nullptr) {
+                table->extendSchema(updated);
+                table->addToColumnStats(updated);
+                table->stats.row_count++;
+                table->stats.data_bytes += Block::encodedSize(updated);
+            }
+            continue;
+        }
+        
+        // No cabe en su bloque: se reubica conservando el ID. El bloque
+        // original no puede ser el destino (ni siquiera cabe sin fill factor)
+        // y el mapa record_block actúa como entrada de reenvío al bloque nuevo.
+        if (table != nullptr && placeRecord(table, updated) != nullptr) {
+            block->extractRecord(record_id);
+            relocated++;
+            disk_manager.getBufferManager().updateUsage(block);
+        } else {
+            output << "Error: Could not relocate record " << record_id << "\n";
+            indexRecord(*current, block->block_id);
+            if (table != nullptr) {
+                table->addToColumnStats(*current);
+                table->stats.row_count++;
+                table->stats.data_bytes += Block::encodedSize(*current);
+            }
+        }
     }
     
-    bool success = target_block->addRecord(record);
+    // Las actualizaciones no cambian los IDs: solo se invalidan las
+    // entradas cuyos predicados leen algún atributo asignado
+    if (in_place + relocated > 0) {
+        std::set<std::string> assigned;
+        for (const auto& assignment : assignments) {
+            assigned.insert(assignment.first);
+        }
+        for (const auto& name : updated_tables) {
+            result_cache.invalidate(name, assigned);
+        }
+    }
     
-    if (success) {
-        double elapsed_time = timer.getElapsedTime();
-        std::cout << "Record " << record.record_id << " added successfully in " 
-                  << elapsed_time << " ms\n";
-        std::cout << "Location: ";
-        target_block->location.print();
+    double elapsed_time = timer.getElapsedTime();
+    output << "Updated " << (in_place + relocated) << " records in " << elapsed_time 
+           << " ms (" << in_place << " in place, " << relocated << " relocated)\n";
+    return in_place + relocated;
+}
+
+void SGBD::indexRecord(const Record& record, int block_id) {
+    restoreDeferred();
+    record_block[record.record_id] = block_id;
+    for (auto& pair : indexes) {
+        auto it = record.data.find(pair.first);
+        if (it != record.data.end()) {
+            pair.second.insert(it->second, record.record_id);
+        }
+    }
+    for (auto& pair : prefix_indexes) {
+        auto it = record.data.find(pair.first);
+        if (it != record.data.end()) {
+            pair.second.insert(it->second, record.record_id);
+        }
+    }
+}
+
+void SGBD::unindexRecord(const Record& record) {
+    restoreDeferred();
+    record_block.erase(record.record_id);
+    for (auto& pair : indexes) {
+        auto it = record.data.find(pair.first);
+        if (it != record.data.end()) {
+            pair.second.remove(it->second, record.record_id);
+        }
+    }
+    for (auto& pair : prefix_indexes) {
+        auto it = record.data.find(pair.first);
+        if (it != record.data.end()) {
+            pair.second.remove(it->second, record.record_id);
+        }
+    }
+}
+
+Block* SGBD::findBlockOfRecord(int record_id) {
+    restoreDeferred();
+    auto it = record_block.find(record_id);
+    if (it != record_block.end()) {
+        auto block_it = all_blocks.find(it->second);
+        if (block_it != all_blocks.end()) {
+            return fetchBlock(block_it->second);
+        }
     }
     
-    return success;
+    // Registro no registrado en el mapa: recorrer los bloques cargados
+    for (auto& pair : all_blocks) {
+        if (pair.second->findRecord(record_id) != nullptr) {
+            return pair.second;
+        }
+    }
+    return nullptr;
 }
 
-Record* SGBD::findRecord(int record_id) {
+bool SGBD::createIndex(const std::string& attribute) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    restoreDeferred();
+    if (indexes.count(attribute)) {
+        output << "Index on " << attribute << " already exists\n";
+        return false;
+    }
+    
     Timer timer;
     timer.start();
     
+    HashIndex index(attribute);
     for (auto& pair : all_blocks) {
-        Record* record = pair.second->findRecord(record_id);
-        if (record != nullptr) {
-            double elapsed_time = timer.getElapsedTime();
-            std::cout << "Record found in " << elapsed_time << " ms\n";
-            std::cout << "Location: ";
-            pair.second->location.print();
-            return record;
+        if (fetchBlock(pair.second) == nullptr) continue;
+        for (const auto& record : pair.second->records) {
+            if (record.is_deleted) continue;
+            auto it = record.data.find(attribute);
+            if (it != record.data.end()) {
+                index.insert(it->second, record.record_id);
+            }
         }
     }
     
-    std::cout << "Record not found\n";
-    return nullptr;
+    double elapsed_time = timer.getElapsedTime();
+    output << "Index on " << attribute << " created with " << index.getEntryCount() 
+           << " entries in " << elapsed_time << " ms\n";
+    indexes[attribute] = index;
+    return true;
 }
 
-std::vector<Record*> SGBD::findRecordsByAttribute(const std::string& attribute, 
-                                           const std::string& value, 
-                                           const std::string& operator_type) {
+bool SGBD::createPrefixIndex(const std::string& attribute) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    restoreDeferred();
+    if (prefix_indexes.count(attribute)) {
+        output << "Prefix index on " << attribute << " already exists\n";
+        return false;
+    }
+    
     Timer timer;
     timer.start();
     
-    std::vector<Record*> results;
+    // Construcción con vistas: solo se decodifica la columna indexada y los
+    // bloques no residentes no se cargan en el buffer
+    PrefixIndex index(attribute);
+    scan(Predicate(), [&index, &attribute](const RecordView& view) {
+        std::string_view value;
+        if (view.get(attribute, value)) {
+            index.insert(std::string(value), view.getId());
+        }
+        return true;
+    });
     
-    for (auto& pair : all_blocks) {
-        std::vector<Record*> block_results = pair.second->findRecordsByAttribute(
-            attribute, value, operator_type);
+    double elapsed_time = timer.getElapsedTime();
+    output << "Prefix index on " << attribute << " created with " << index.getEntryCount() 
+           << " entries in " << elapsed_time << " ms\n";
+    prefix_indexes.emplace(attribute, std::move(index));
+    return true;
+}
+
+double SGBD::estimateRows(const Predicate& predicate, const std::string& table_name) const {
+    double rows = 0.0;
+    for (const auto& name : catalog.getTableNames()) {
+        if (!table_name.empty() && name != table_name) continue;
+        const Table* table = catalog.getTable(name);
+        rows += table->estimateSelectivity(predicate) * table->stats.row_count;
+    }
+    return rows;
+}
+
+bool SGBD::analyze(const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    if (!table_name.empty() && !catalog.hasTable(table_name)) {
+        output << "Error: Table " << table_name << " does not exist\n";
+        return false;
+    }
+    
+    Timer timer;
+    timer.start();
+    
+    for (const auto& name : catalog.getTableNames()) {
+        if (!table_name.empty() && name != table_name) continue;
+        Table* table = catalog.getTable(name);
+        
+        // Recoger los valores activos de cada columna del esquema
+        std::map<std::string, std::vector<std::string>> values;
+        for (const auto& column : table->schema) {
+            values[column].reserve(table->stats.row_count);
+        }
+        for (Block* block : getTableBlocks(name)) {
+            if (fetchBlock(block) == nullptr) continue;
+            for (const auto& record : block->records) {
+                if (record.is_deleted) continue;
+                for (const auto& pair : record.data) {
+                    values[pair.first].push_back(pair.second);
+                }
+            }
+        }
         
-        for (Record* record : block_results) {
-            results.push_back(record);
+        table->column_stats.clear();
+        for (auto& pair : values) {
+            table->column_stats[pair.first].rebuild(std::move(pair.second), HISTOGRAM_BUCKETS);
         }
+        table->analyzed = true;
+        table->printColumnStats();
     }
     
     double elapsed_time = timer.getElapsedTime();
-    std::cout << "Query completed in " << elapsed_time << " ms\n";
-    std::cout << "Found " << results.size() << " records\n";
+    output << "Analyze completed in " << elapsed_time << " ms\n";
+    return true;
+}
+
+bool SGBD::startBackgroundWriter(const WriterConfig& config) {
+    if (!background_writer.start(config)) {
+        output << "Background writer already running\n";
+        return false;
+    }
+    output << "Background writer started (" << config.io_bytes_per_second 
+           << " bytes/s, every " << config.interval_ms << " ms, checkpoint every " 
+           << config.checkpoint_interval_ms << " ms)\n";
+    return true;
+}
+
+void SGBD::stopBackgroundWriter() {
+    background_writer.stop();
+}
+
+bool SGBD::runBackgroundWriterRound() {
+    // Sin el latch, como start/stop: la ronda lo toma para cada bloque
+    return background_writer.runRound();
+}
+
+void SGBD::getEvictionStats(long long& evictions, long long& dirty_evictions) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    BufferManager& buffer = disk_manager.getBufferManager();
+    evictions = buffer.getEvictions();
+    dirty_evictions = buffer.getDirtyEvictions();
+}
+
+void SGBD::checkpoint() {
+    Timer timer;
+    timer.start();
+    
+    if (background_writer.isRunning()) {
+        background_writer.requestCheckpoint();
+        output << "Checkpoint requested from the background writer\n";
+        return;
+    }
+    
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    BufferManager& buffer = disk_manager.getBufferManager();
+    buffer.beginCheckpoint();
+    int written = 0;
+    while (buffer.writeCheckpointBlock() > 0) {
+        written++;
+    }
+    double elapsed_time = timer.getElapsedTime();
+    output << "Checkpoint wrote " << written << " blocks in " << elapsed_time << " ms\n";
+}
+
+bool SGBD::saveSnapshot(const std::string& path) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    restoreDeferred();
+    Timer timer;
+    timer.start();
+    
+    // Volcar los bloques sucios (como un checkpoint, sin un mensaje por
+    // bloque) para que los sectores tengan el contenido vigente
+    BufferManager& buffer = disk_manager.getBufferManager();
+    buffer.beginCheckpoint();
+    while (buffer.writeCheckpointBlock() > 0) {}
+    if (buffer.getDirtyCount() > 0) {
+        output << "Error: Snapshot aborted, " << buffer.getDirtyCount() 
+               << " blocks could not be written\n";
+        return false;
+    }
+    
+    // El disco, que es la sección más grande, se codifica en paralelo
+    std::vector<std::pair<SnapshotSection, std::string>> sections(5);
+    sections[0].first = SnapshotSection::DISK;
+    std::thread disk_thread([this, &sections] {
+        SnapshotWriter out(sections[0].second);
+        disk_manager.saveSectors(out);
+    });
+    
+    sections[1].first = SnapshotSection::CATALOG;
+    SnapshotWriter catalog_out(sections[1].second);
+    catalog_out.putI32(next_record_id);
+    catalog_out.putI32(next_block_id);
+    catalog.save(catalog_out);
+    catalog_out.putU32(static_cast<uint32_t>(indexes.size()));
+    for (const auto& pair : indexes) {
+        catalog_out.putString(pair.first);
+    }
+    catalog_out.putU32(static_cast<uint32_t>(prefix_indexes.size()));
+    for (const auto& pair : prefix_indexes) {
+        catalog_out.putString(pair.first);
+    }
+    
+    sections[2].first = SnapshotSection::BLOCKS;
+    SnapshotWriter blocks_out(sections[2].second);
+    std::vector<int> block_ids;
+    block_ids.reserve(all_blocks.size());
+    for (const auto& pair : all_blocks) {
+        block_ids.push_back(pair.first);
+    }
+    std::sort(block_ids.begin(), block_ids.end());
+    blocks_out.putU32(static_cast<uint32_t>(block_ids.size()));
+    for (int block_id : block_ids) {
+        all_blocks[block_id]->saveMetadata(blocks_out);
+    }
+    
+    sections[3].first = SnapshotSection::LOCATOR;
+    SnapshotWriter locator_out(sections[3].second);
+    sections[3].second.reserve(4 + record_block.size() * 8);
+    locator_out.putU32(static_cast<uint32_t>(record_block.size()));
+    for (const auto& pair : record_block) {
+        locator_out.putI32(pair.first);
+        locator_out.putI32(pair.second);
+    }
+    
+    sections[4].first = SnapshotSection::INDEXES;
+    SnapshotWriter indexes_out(sections[4].second);
+    indexes_out.putU32(static_cast<uint32_t>(indexes.size()));
+    for (const auto& pair : indexes) {
+        pair.second.save(indexes_out);
+    }
+    indexes_out.putU32(static_cast<uint32_t>(prefix_indexes.size()));
+    for (const auto& pair : prefix_indexes) {
+        pair.second.save(indexes_out);
+    }
+    disk_thread.join();
+    
+    std::string error;
+    if (!SnapshotFile::write(path, sections, error)) {
+        output << "Error: " << error << "\n";
+        return false;
+    }
+    size_t total_bytes = 0;
+    for (const auto& section : sections) {
+        total_bytes += section.second.size();
+    }
+    
+    double elapsed_time = timer.getElapsedTime();
+    output << "Snapshot saved to " << path << " (" << total_bytes << " bytes, " 
+           << all_blocks.size() << " blocks, " << record_block.size() << " records, "
+           << (indexes.size() + prefix_indexes.size()) << " indexes) in " 
+           << elapsed_time << " ms\n";
+    return true;
+}
+
+bool SGBD::loadSnapshot(const std::string& path) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    if (!all_blocks.empty() || catalog.getTableCount() > 0 || deferred_snapshot != nullptr) {
+        output << "Error: A snapshot can only be loaded into an empty database\n";
+        return false;
+    }
+    Timer timer;
+    timer.start();
+    
+    auto file = std::make_unique<SnapshotFile>();
+    std::string error;
+    if (!file->open(path, error)) {
+        output << "Error: " << error << "\n";
+        return false;
+    }
+    
+    // El contenido del disco se copia en otro hilo mientras se leen el
+    // catálogo y los metadatos de los bloques
+    std::string disk_error;
+    bool disk_ok = false;
+    std::thread disk_thread([this, &file, &disk_error, &disk_ok] {
+        SnapshotReader in;
+        disk_ok = file->openSection(SnapshotSection::DISK, in, disk_error) &&
+                  disk_manager.loadSectors(in, disk_error);
+    });
+    
+    Catalog restored_catalog;
+    int restored_record_id = 0;
+    int restored_block_id = 0;
+    std::vector<std::string> hash_names, prefix_names;
+    std::vector<std::unique_ptr<Block>> blocks;
+    
+    SnapshotReader in;
+    bool ok = file->openSection(SnapshotSection::CATALOG, in, error);
+    uint32_t count = 0;
+    if (ok) {
+        ok = in.getI32(restored_record_id) && in.getI32(restored_block_id) &&
+             restored_catalog.load(in) && in.getCount(count, 4);
+        for (uint32_t i = 0; ok && i < count; ++i) {
+            hash_names.emplace_back();
+            ok = in.getString(hash_names.back());
+        }
+        ok = ok && in.getCount(count, 4);
+        for (uint32_t i = 0; ok && i < count; ++i) {
+            prefix_names.emplace_back();
+            ok = in.getString(prefix_names.back());
+        }
+        if (!ok) error = "invalid catalog section in " + path;
+    }
+    
+    if (ok) {
+        ok = file->openSection(SnapshotSection::BLOCKS, in, error);
+    }
+    if (ok) {
+        ok = in.getCount(count, 64);
+        blocks.reserve(count);
+        for (uint32_t i = 0; ok && i < count; ++i) {
+            blocks.push_back(std::make_unique<Block>(-1, 0));
+            ok = blocks.back()->loadMetadata(in, disk_manager);
+        }
+        if (!ok) error = "invalid block section in " + path;
+    }
+    disk_thread.join();
+    
+    if (!ok || !disk_ok) {
+        // Nada de la instantánea queda a medias: el disco vuelve a estar vacío
+        disk_manager.clearSectors();
+        output << "Error: " << (ok ? disk_error : error) << "\n";
+        return false;
+    }
+    
+    catalog = std::move(restored_catalog);
+    next_record_id = restored_record_id;
+    next_block_id = restored_block_id;
+    all_blocks.reserve(blocks.size());
+    for (auto& block : blocks) {
+        int block_id = block->block_id;
+        disk_manager.addStoredBlockBytes(static_cast<long long>(block->stored_bytes));
+        all_blocks[block_id] = block.release();
+    }
+    deferred_hash_indexes = std::move(hash_names);
+    deferred_prefix_indexes = std::move(prefix_names);
+    size_t file_bytes = file->getSize();
+    deferred_snapshot = std::move(file);
+    
+    double elapsed_time = timer.getElapsedTime();
+    output << "Snapshot " << path << " loaded (" << file_bytes << " bytes, " 
+           << catalog.getTableCount() << " tables, " << all_blocks.size() 
+           << " blocks) in " << elapsed_time 
+           << " ms; record locator and indexes deferred to first use\n";
+    return true;
+}
+
+bool SGBD::restoreLocator(const SnapshotFile& file, std::string& error) {
+    SnapshotReader in;
+    uint32_t count;
+    if (!file.openSection(SnapshotSection::LOCATOR, in, error)) return false;
+    if (!in.getCount(count, 8)) {
+        error = "invalid locator section";
+        return false;
+    }
+    record_block.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        int record_id, block_id;
+        in.getI32(record_id);
+        in.getI32(block_id);
+        record_block.emplace(record_id, block_id);
+    }
+    return true;
+}
+
+bool SGBD::restoreIndexes(const SnapshotFile& file, std::string& error) {
+    SnapshotReader in;
+    uint32_t count;
+    if (!file.openSection(SnapshotSection::INDEXES, in, error)) return false;
+    
+    bool ok = in.getCount(count, 8);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        HashIndex index;
+        ok = index.load(in);
+        if (ok) indexes[index.getAttribute()] = std::move(index);
+    }
+    ok = ok && in.getCount(count, 8);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        PrefixIndex index;
+        ok = index.load(in);
+        if (ok) prefix_indexes.emplace(index.getAttribute(), std::move(index));
+    }
+    if (!ok) error = "invalid index section";
+    return ok;
+}
+
+void SGBD::restoreDeferred() {
+    if (deferred_snapshot == nullptr) return;
+    
+    // Se retira antes de reconstruir: createIndex y las demás operaciones
+    // que se usan como respaldo vuelven a pasar por aquí
+    std::unique_ptr<SnapshotFile> file = std::move(deferred_snapshot);
+    std::vector<std::string> hash_names = std::move(deferred_hash_indexes);
+    std::vector<std::string> prefix_names = std::move(deferred_prefix_indexes);
+    deferred_hash_indexes.clear();
+    deferred_prefix_indexes.clear();
+    Timer timer;
+    timer.start();
+    
+    // Mapa de ubicaciones e índices son independientes: uno en cada hilo
+    std::string locator_error, index_error;
+    bool locator_ok = false;
+    std::thread locator_thread([this, &file, &locator_error, &locator_ok] {
+        locator_ok = restoreLocator(*file, locator_error);
+    });
+    bool indexes_ok = restoreIndexes(*file, index_error);
+    locator_thread.join();
+    
+    if (!locator_ok) {
+        output << "Warning: " << locator_error << "; rebuilding the record locator from the blocks\n";
+        record_block.clear();
+        for (auto& pair : all_blocks) {
+            if (fetchBlock(pair.second) == nullptr) continue;
+            for (const auto& record : pair.second->records) {
+                if (!record.is_deleted) {
+                    record_block[record.record_id] = pair.first;
+                }
+            }
+        }
+    }
+    if (!indexes_ok) {
+        output << "Warning: " << index_error << "; rebuilding the indexes from the blocks\n";
+        indexes.clear();
+        prefix_indexes.clear();
+        for (const auto& name : hash_names) {
+            createIndex(name);
+        }
+        for (const auto& name : prefix_names) {
+            createPrefixIndex(name);
+        }
+    }
+    
+    double elapsed_time = timer.getElapsedTime();
+    output << "Record locator (" << record_block.size() << " records) and " 
+           << (indexes.size() + prefix_indexes.size()) << " indexes restored from " 
+           << file->getPath() << " in " << elapsed_time << " ms\n";
+}
+
+void SGBD::setResultCacheCapacity(size_t capacity_bytes) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    result_cache.setCapacity(capacity_bytes);
+    if (capacity_bytes == 0) {
+        result_cache.clear();
+        output << "Result cache disabled\n";
+    } else {
+        output << "Result cache enabled with " << capacity_bytes << " bytes\n";
+    }
+}
+
+bool SGBD::createBloomFilter(const std::string& table_name, const std::string& column,
+                             double fpr) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    Table* table = catalog.getTable(table_name);
+    if (table == nullptr) {
+        output << "Error: Table " << table_name << " does not exist\n";
+        return false;
+    }
+    if (fpr <= 0.0 || fpr >= 1.0) {
+        output << "Error: Invalid false positive rate " << fpr << "\n";
+        return false;
+    }
+    
+    Timer timer;
+    timer.start();
+    
+    table->bloom_columns[column] = fpr;
+    size_t filter_bytes = 0;
+    for (Block* block : getTableBlocks(table_name)) {
+        if (fetchBlock(block) == nullptr) continue;
+        block->enableBloomFilter(column, fpr);
+        filter_bytes += block->bloom_filters[column].getMemoryBytes();
+    }
+    
+    double elapsed_time = timer.getElapsedTime();
+    output << "Bloom filter on " << table_name << "." << column << " (target FPR " 
+           << fpr * 100 << "%) built for " << table->block_ids.size() << " blocks, "
+           << filter_bytes << " bytes, in " << elapsed_time << " ms\n";
+    return true;
+}
+
+bool SGBD::findRecord(int record_id, Record& record) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    Timer timer;
+    timer.start();
+    
+    Block* block = findBlockOfRecord(record_id);
+    const Record* found = (block != nullptr) ? block->findRecord(record_id) : nullptr;
+    if (found != nullptr) {
+        record = *found;
+        double elapsed_time = timer.getElapsedTime();
+        output << "Record found in " << elapsed_time << " ms\n";
+        output << "Location: ";
+        block->location.print(output);
+        return true;
+    }
+    
+    output << "Record not found\n";
+    return false;
+}
+
+std::vector<Record> SGBD::findRecordsByAttribute(const std::string& attribute, 
+                                                 const std::string& value, 
+                                                 const std::string& operator_type,
+                                                 const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    CompareOp op;
+    if (!parseCompareOp(operator_type, op)) {
+        output << "Error: Invalid operator " << operator_type << "\n";
+        return std::vector<Record>();
+    }
+    return query(Predicate::comparison(attribute, op, value), table_name);
+}
+
+std::vector<Record> SGBD::query(const std::string& expression, const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    Predicate predicate;
+    std::string error;
+    if (!Predicate::parse(expression, predicate, error)) {
+        output << "Error: Invalid query expression: " << error << "\n";
+        return std::vector<Record>();
+    }
+    return query(predicate, table_name);
+}
+
+std::vector<Record> SGBD::query(const Predicate& predicate, const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    Timer timer;
+    timer.start();
+    
+    std::vector<Record> results;
+    auto collect = [&results](const Record& record) {
+        results.push_back(record);
+    };
+    std::string cache_key;
+    const std::vector<int>* cached = nullptr;
+    if (result_cache.isEnabled()) {
+        cache_key = ResultCache::makeKey(table_name, predicate.toCanonicalString());
+        cached = result_cache.lookup(cache_key);
+    }
+    
+    if (cached != nullptr) {
+        output << "Plan: result cache hit (" << cached->size() << " row ids)\n";
+        fetchRecords(*cached, table_name, nullptr, collect);
+    } else {
+        executeQuery(predicate, table_name, collect);
+        if (result_cache.isEnabled()) {
+            std::vector<int> record_ids;
+            record_ids.reserve(results.size());
+            for (const Record& record : results) {
+                record_ids.push_back(record.record_id);
+            }
+            result_cache.insert(cache_key, table_name, predicate.getAttributes(), record_ids);
+        }
+    }
+    
+    double elapsed_time = timer.getElapsedTime();
+    output << "Query completed in " << elapsed_time << " ms\n";
+    output << "Found " << results.size() << " records\n";
+    
+    return results;
+}
+
+void SGBD::executeQuery(const Predicate& predicate, const std::string& table_name,
+                        const std::function<void(const Record&)>& consumer) {
+    // Sin índices en la instantánea, los recorridos no necesitan esperar a
+    // que se reconstruya el mapa de ubicaciones
+    if (!deferred_hash_indexes.empty() || !deferred_prefix_indexes.empty()) {
+        restoreDeferred();
+    }
+    
+    // Elegir el índice más selectivo entre las igualdades del AND raíz,
+    // según la selectividad estimada por las estadísticas de columna
+    const HashIndex* best_index = nullptr;
+    const Comparison* best_conjunct = nullptr;
+    double best_rows = 0.0;
+    std::vector<Comparison> conjuncts = predicate.getConjuncts();
+    
+    for (const auto& conjunct : conjuncts) {
+        if (conjunct.op != CompareOp::EQ) continue;
+        auto it = indexes.find(conjunct.attribute);
+        if (it == indexes.end()) continue;
+        
+        double rows = estimateRows(Predicate::comparison(conjunct.attribute, conjunct.op, 
+                                                         conjunct.value), table_name);
+        if (best_index == nullptr || rows < best_rows) {
+            best_index = &it->second;
+            best_conjunct = &conjunct;
+            best_rows = rows;
+        }
+    }
+    
+    double total_rows = estimateRows(Predicate(), table_name);
+    double estimated_rows = estimateRows(predicate, table_name);
+    
+    // El índice solo compensa si selecciona una fracción pequeña de la tabla:
+    // cada candidato se resuelve con un acceso aleatorio a su bloque
+    const std::vector<int>* best_candidates = nullptr;
+    std::string index_attribute;
+    bool index_usable = false;
+    if (best_index != nullptr) {
+        if (best_rows <= total_rows * INDEX_SELECTIVITY_THRESHOLD) {
+            best_candidates = best_index->lookup(best_conjunct->value);
+            index_attribute = best_conjunct->attribute;
+            index_usable = true;
+        } else {
+            output << "Index on " << best_conjunct->attribute << " not selective (~" 
+                   << std::llround(best_rows) << " of " << std::llround(total_rows) 
+                   << " rows)\n";
+        }
+    }
+    
+    // Índice de prefijos: el árbol da el número exacto de candidatos sin
+    // recorrerlos, así que se compara directamente con el índice hash
+    const PrefixIndex* best_prefix = nullptr;
+    const Comparison* prefix_conjunct = nullptr;
+    int prefix_rows = 0;
+    for (const auto& conjunct : conjuncts) {
+        if (conjunct.op != CompareOp::PREFIX) continue;
+        auto it = prefix_indexes.find(conjunct.attribute);
+        if (it == prefix_indexes.end()) continue;
+        
+        int rows = it->second.countPrefix(conjunct.value);
+        if (best_prefix == nullptr || rows < prefix_rows) {
+            best_prefix = &it->second;
+            prefix_conjunct = &conjunct;
+            prefix_rows = rows;
+        }
+    }
+    if (best_prefix != nullptr && (!index_usable || prefix_rows < best_rows)) {
+        if (prefix_rows <= total_rows * INDEX_SELECTIVITY_THRESHOLD) {
+            output << "Plan: prefix index on " << prefix_conjunct->attribute << " (" 
+                   << prefix_rows << " candidates)\n";
+            fetchRecords(best_prefix->lookupPrefix(prefix_conjunct->value), 
+                         table_name, &predicate, consumer);
+            return;
+        }
+        output << "Prefix index on " << prefix_conjunct->attribute << " not selective (" 
+               << prefix_rows << " of " << std::llround(total_rows) << " rows)\n";
+    }
+    
+    if (index_usable) {
+        output << "Plan: index lookup on " << index_attribute << " (estimated " 
+               << std::llround(estimated_rows) << " rows)\n";
+        if (best_candidates != nullptr) {
+            fetchRecords(*best_candidates, table_name, &predicate, consumer);
+        }
+        return;
+    }
+    
+    int skipped;
+    std::vector<bool> bloom_consulted;
+    std::vector<Block*> blocks = pruneBlocks(getTableBlocks(table_name), predicate, 
+                                             skipped, &bloom_consulted);
+    output << "Plan: full scan, estimated " << std::llround(estimated_rows) << " rows (" 
+           << skipped << " of " << (blocks.size() + skipped) 
+           << " blocks skipped by zone maps and Bloom filters)\n";
+    // Un bloque fijado cada vez: al soltarlo el buffer puede desalojarlo
+    // para cargar el siguiente sin pasarse del presupuesto
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        BlockPin pin(disk_manager.getBufferManager(), blocks[i]);
+        if (pin.get() == nullptr) continue;
+        bool matched = false;
+        for (const Record& record : blocks[i]->records) {
+            if (record.is_deleted || !predicate.evaluate(record)) continue;
+            matched = true;
+            consumer(record);
+        }
+        if (bloom_consulted[i] && !matched) {
+            // Cota superior: el bloque pudo fallar por otra condición del predicado
+            bloom_false_positives++;
+        }
+    }
+}
+
+void SGBD::fetchRecords(const std::vector<int>& record_ids, const std::string& table_name,
+                        const Predicate* predicate,
+                        const std::function<void(const Record&)>& consumer) {
+    for (int record_id : record_ids) {
+        Block* block = findBlockOfRecord(record_id);
+        if (block == nullptr) continue;
+        if (!table_name.empty() && block->table_name != table_name) continue;
+        // findBlockOfRecord deja el bloque cargado hasta la siguiente carga
+        const Record* record = block->findRecord(record_id);
+        if (record != nullptr && (predicate == nullptr || predicate->evaluate(*record))) {
+            consumer(*record);
+        }
+    }
+}
+
+SGBD::ViewBuffersLease::ViewBuffersLease(ViewBuffers& shared, bool& shared_busy)
+    : buffers(&local), busy(nullptr) {
+    if (!shared_busy) {
+        shared_busy = true;
+        buffers = &shared;
+        busy = &shared_busy;
+    }
+}
+
+SGBD::ViewBuffersLease::~ViewBuffersLease() {
+    if (busy != nullptr) {
+        *busy = false;
+    }
+}
+
+SGBD::ViewBuffers& SGBD::ViewBuffersLease::get() {
+    return *buffers;
+}
+
+bool SGBD::readEncodedBlock(const Block* block, ViewBuffers& buffers) {
+    // Un bloque sin cargar está limpio: su versión en disco es la vigente
+    if (block->is_loaded || block->extents.empty()) {
+        return false;
+    }
+    disk_manager.readExtents(block->extents, buffers.bytes);
+    return buffers.block.open(buffers.bytes);
+}
+
+long long SGBD::scan(const Predicate& predicate,
+                     const std::function<bool(const RecordView&)>& consumer,
+                     const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    ViewBuffersLease lease(view_buffers, view_buffers_busy);
+    ViewBuffers& buffers = lease.get();
+    
+    BufferManager& buffer = disk_manager.getBufferManager();
+    int skipped;
+    std::vector<Block*> blocks = pruneBlocks(getTableBlocks(table_name), predicate, skipped);
+    long long delivered = 0;
+    bool more = true;
+    
+    for (size_t i = 0; i < blocks.size() && more; ++i) {
+        Block* block = blocks[i];
+        if (readEncodedBlock(block, buffers)) {
+            const EncodedBlock& encoded = buffers.block;
+            for (size_t row = 0; row < encoded.getRowCount() && more; ++row) {
+                if (encoded.isDeleted(row)) continue;
+                RecordView view(encoded, row);
+                if (!predicate.evaluate(view)) continue;
+                delivered++;
+                more = consumer(view);
+            }
+            view_encoded_blocks++;
+            view_columns_decoded += encoded.getColumnsAccessed();
+            continue;
+        }
+        
+        BlockPin pin(buffer, block);
+        if (pin.get() == nullptr) continue;
+        for (const Record& record : block->records) {
+            if (record.is_deleted || !predicate.evaluate(record)) continue;
+            delivered++;
+            if (!consumer(RecordView(record))) {
+                more = false;
+                break;
+            }
+        }
+        view_resident_blocks++;
+    }
+    
+    view_rows += delivered;
+    return delivered;
+}
+
+bool SGBD::lookup(int record_id, const std::function<void(const RecordView&)>& consumer) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    restoreDeferred();
+    auto it = record_block.find(record_id);
+    if (it == record_block.end()) {
+        return false;
+    }
+    auto block_it = all_blocks.find(it->second);
+    if (block_it == all_blocks.end()) {
+        return false;
+    }
+    Block* block = block_it->second;
+    
+    ViewBuffersLease lease(view_buffers, view_buffers_busy);
+    ViewBuffers& buffers = lease.get();
+    
+    bool found = false;
+    if (readEncodedBlock(block, buffers)) {
+        long row = buffers.block.findRow(record_id);
+        if (row >= 0 && !buffers.block.isDeleted(static_cast<size_t>(row))) {
+            found = true;
+            consumer(RecordView(buffers.block, static_cast<size_t>(row)));
+        }
+        view_encoded_blocks++;
+        view_columns_decoded += buffers.block.getColumnsAccessed();
+    } else {
+        BlockPin pin(disk_manager.getBufferManager(), block);
+        if (pin.get() != nullptr) {
+            const Record* record = block->findRecord(record_id);
+            if (record != nullptr) {
+                found = true;
+                consumer(RecordView(*record));
+            }
+            view_resident_blocks++;
+        }
+    }
+    
+    if (found) {
+        view_rows++;
+    }
+    return found;
+}
+
+std::vector<AggregateRow> SGBD::aggregate(const std::vector<std::string>& group_by,
+                                          const std::vector<std::string>& aggregates,
+                                          const std::string& where,
+                                          const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    std::vector<AggregateSpec> specs;
+    for (const auto& text : aggregates) {
+        AggregateSpec spec;
+        if (!AggregateSpec::parse(text, spec)) {
+            output << "Error: Invalid aggregate " << text << "\n";
+            return std::vector<AggregateRow>();
+        }
+        specs.push_back(spec);
+    }
+    
+    Predicate predicate;
+    std::string error;
+    if (!where.empty() && !Predicate::parse(where, predicate, error)) {
+        output << "Error: Invalid query expression: " << error << "\n";
+        return std::vector<AggregateRow>();
+    }
+    
+    Timer timer;
+    timer.start();
+    
+    int skipped;
+    std::vector<Block*> blocks = pruneBlocks(getTableBlocks(table_name), predicate, skipped);
+    
+    AggregationOperator aggregation(group_by, specs, predicate);
+    std::vector<AggregateRow> rows;
+    if (!aggregation.execute(blocks, disk_manager.getBufferManager(), rows)) {
+        output << "Error: Could not load the blocks to aggregate\n";
+        return std::vector<AggregateRow>();
+    }
+    
+    double elapsed_time = timer.getElapsedTime();
+    output << "Aggregation completed in " << elapsed_time << " ms (" 
+           << rows.size() << " groups)\n";
+    aggregation.printResult(rows, output);
+    
+    return rows;
+}
+
+std::vector<JoinedRow> SGBD::hashJoin(const std::string& left_table, const std::string& left_key,
+                                      const std::string& right_table, const std::string& right_key,
+                                      long long memory_budget) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    if (!catalog.hasTable(left_table) || !catalog.hasTable(right_table)) {
+        output << "Error: Unknown table in join\n";
+        return std::vector<JoinedRow>();
+    }
+    if (memory_budget <= 0) {
+        memory_budget = static_cast<long long>(disk_manager.getBufferCapacity());
+    }
+    
+    Timer timer;
+    timer.start();
+    
+    std::vector<Block*> left_blocks = getTableBlocks(left_table);
+    std::vector<Block*> right_blocks = getTableBlocks(right_table);
+    
+    HashJoinOperator join(&disk_manager, left_key, right_key, memory_budget);
+    std::vector<JoinedRow> results;
+    if (!join.execute(left_blocks, right_blocks, results)) {
+        output << "Error: Join of " << left_table << " and " << right_table << " failed\n";
+        return results;
+    }
+    
+    double elapsed_time = timer.getElapsedTime();
+    if (join.getPartitionCount() > 0) {
+        output << "Plan: grace hash join with " << join.getPartitionCount() 
+               << " partitions spilled to disk\n";
+    } else {
+        output << "Plan: in-memory hash join\n";
+    }
+    output << "Join " << left_table << "." << left_key << " = " 
+           << right_table << "." << right_key << " produced " << results.size() 
+           << " rows in " << elapsed_time << " ms\n";
     
     return results;
 }
 
-std::vector<Record*> SGBD::getAllRecords() {
+std::vector<Record> SGBD::orderBy(const std::string& table_name, const std::string& order_by,
+                                  size_t limit, const std::string& where,
+                                  long long memory_budget) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    std::vector<Record> results;
+    orderBy(table_name, order_by, 
+            [&results](const Record& record) {
+                results.push_back(record);
+                return true;
+            },
+            limit, where, memory_budget);
+    return results;
+}
+
+bool SGBD::orderBy(const std::string& table_name, const std::string& order_by,
+                   const std::function<bool(const Record&)>& consumer,
+                   size_t limit, const std::string& where, long long memory_budget) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    std::vector<SortKey> keys;
+    if (!SortKey::parseList(order_by, keys)) {
+        output << "Error: Invalid ORDER BY clause: " << order_by << "\n";
+        return false;
+    }
+    
+    Predicate predicate;
+    std::string error;
+    if (!where.empty() && !Predicate::parse(where, predicate, error)) {
+        output << "Error: Invalid query expression: " << error << "\n";
+        return false;
+    }
+    
+    if (memory_budget <= 0) {
+        memory_budget = static_cast<long long>(disk_manager.getBufferCapacity());
+    }
+    
     Timer timer;
     timer.start();
     
-    std::vector<Record*> results;
+    int skipped;
+    std::vector<Block*> blocks = pruneBlocks(getTableBlocks(table_name), predicate, skipped);
     
-    for (auto& pair : all_blocks) {
-        for (auto& record : pair.second->records) {
+    size_t delivered = 0;
+    SortOperator sort(&disk_manager, keys, memory_budget, limit);
+    bool success = sort.execute(blocks, predicate,
+                                [&](const Record& record) {
+                                    delivered++;
+                                    return consumer(record);
+                                });
+    
+    double elapsed_time = timer.getElapsedTime();
+    if (limit > 0) {
+        output << "Plan: top-" << limit << " heap\n";
+    } else if (sort.getRunCount() > 0) {
+        output << "Plan: external merge sort (" << sort.getRunCount() << " runs, "
+               << sort.getMergePasses() << " merge passes)\n";
+    } else {
+        output << "Plan: in-memory sort\n";
+    }
+    output << "ORDER BY " << order_by << " returned " << delivered 
+           << " records in " << elapsed_time << " ms\n";
+    
+    return success;
+}
+
+std::vector<Record> SGBD::getAllRecords(const std::string& table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    Timer timer;
+    timer.start();
+    
+    std::vector<Record> results;
+    
+    for (Block* block : getTableBlocks(table_name)) {
+        BlockPin pin(disk_manager.getBufferManager(), block);
+        if (pin.get() == nullptr) {
+            output << "Error: Could not load block " << block->block_id << "\n";
+            return std::vector<Record>();
+        }
+        for (const auto& record : block->records) {
             if (!record.is_deleted) {
-                results.push_back(&record);
+                results.push_back(record);
             }
         }
     }
     
     double elapsed_time = timer.getElapsedTime();
-    std::cout << "Retrieved all " << results.size() << " records in " 
-              << elapsed_time << " ms\n";
+    output << "Retrieved all " << results.size() << " records in " 
+           << elapsed_time << " ms\n";
     
     return results;
 }
 
 bool SGBD::deleteRecord(int record_id) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
     Timer timer;
     timer.start();
     
-    for (auto& pair : all_blocks) {
-        if (pair.second->removeRecord(record_id)) {
-            double elapsed_time = timer.getElapsedTime();
-            std::cout << "Record " << record_id << " deleted in " 
-                      << elapsed_time << " ms\n";
-            std::cout << "Location: ";
-            pair.second->location.print();
-            return true;
+    Block* block = findBlockOfRecord(record_id);
+    Record* record = (block != nullptr) ? block->findRecord(record_id) : nullptr;
+    if (record != nullptr) {
+        Table* table = catalog.getTable(block->table_name);
+        if (table != nullptr) {
+            table->stats.row_count--;
+            table->stats.deleted_count++;
+            table->stats.data_bytes -= Block::encodedSize(*record);
+            table->removeFromColumnStats(*record);
         }
+        unindexRecord(*record);
+        result_cache.invalidate(block->table_name, *record);
+        block->removeRecord(record_id);
+        
+        double elapsed_time = timer.getElapsedTime();
+        output << "Record " << record_id << " deleted in " 
+               << elapsed_time << " ms\n";
+        output << "Location: ";
+        block->location.print(output);
+        return true;
     }
     
-    std::cout << "Record not found for deletion\n";
+    output << "Record not found for deletion\n";
     return false;
 }
 
 void SGBD::showBlockContent(int block_id) {
+    std::lock_guard<std::recursive_mutex> guard(latch);
     Timer timer;
     timer.start();
     
     auto it = all_blocks.find(block_id);
-    if (it != all_blocks.end()) {
+    if (it != all_blocks.end() && fetchBlock(it->second) != nullptr) {
         it->second->print();
         double elapsed_time = timer.getElapsedTime();
         std::cout << "Block content displayed in " << elapsed_time << " ms\n";
@@ -205,50 +1531,191 @@ void SGBD::showBlockContent(int block_id) {
 }
 
 void SGBD::showAllBlocks() {
+    std::lock_guard<std::recursive_mutex> guard(latch);
     std::cout << "\n=== All Blocks Information ===\n";
     for (auto& pair : all_blocks) {
-        pair.second->print();
+        if (fetchBlock(pair.second) != nullptr) {
+            pair.second->print();
+        }
     }
 }
 
+void SGBD::showCatalog() {
+    std::lock_guard<std::recursive_mutex> guard(latch);
+    catalog.print();
+}
+
 void SGBD::showSystemStats() {
+    std::lock_guard<std::recursive_mutex> guard(latch);
     std::cout << "\n=== System Statistics ===\n";
     disk_manager.printDiskStatus();
     disk_manager.getBufferManager().printBufferStatus();
+    background_writer.printStats();
+    catalog.print();
     
     std::cout << "\nBlocks Information:\n";
     std::cout << "Total blocks: " << all_blocks.size() << "\n";
     
+    // Contadores del catálogo: no obligan a cargar los bloques descargados
     int total_records = 0;
     int deleted_records = 0;
+    for (const auto& name : catalog.getTableNames()) {
+        const Table* table = catalog.getTable(name);
+        total_records += table->stats.row_count + table->stats.deleted_count;
+        deleted_records += table->stats.deleted_count;
+    }
+    
+    std::cout << "Total records: " << total_records << "\n";
+    std::cout << "Active records: " << (total_records - deleted_records) << "\n";
+    std::cout << "Deleted records: " << deleted_records << "\n";
     
+    // Tamaño lógico de los registros frente a los bytes almacenados en disco
+    // (los bloques sucios cuentan con el tamaño de su última escritura)
+    long long logical_bytes = 0;
     for (auto& pair : all_blocks) {
-        for (auto& record : pair.second->records) {
-            total_records++;
-            if (record.is_deleted) {
-                deleted_records++;
+        logical_bytes += pair.second->used_bytes;
+    }
+    long long stored_bytes = disk_manager.getStoredBlockBytes();
+    std::cout << "Logical data: " << logical_bytes << " bytes, compressed blocks on disk: " 
+              << stored_bytes << " bytes";
+    if (stored_bytes > 0) {
+        std::cout << " (ratio " << static_cast<double>(logical_bytes) / stored_bytes << "x)";
+    }
+    std::cout << "\n";
+    
+    printMemoryUsage();
+    
+    if (view_rows > 0 || view_resident_blocks + view_encoded_blocks > 0) {
+        std::cout << "\nRecord views: " << view_rows << " rows delivered from " 
+                  << view_resident_blocks << " resident and " << view_encoded_blocks 
+                  << " encoded blocks (" << view_columns_decoded 
+                  << " columns decoded in the encoded ones)\n";
+    }
+    
+    if (result_cache.isEnabled()) {
+        std::cout << "\n";
+        result_cache.print();
+    }
+    
+    if (deferred_snapshot != nullptr) {
+        std::cout << "\nSnapshot " << deferred_snapshot->getPath() << ": record locator and "
+                  << (deferred_hash_indexes.size() + deferred_prefix_indexes.size()) 
+                  << " indexes not restored yet\n";
+    }
+    
+    if (!indexes.empty() || !prefix_indexes.empty()) {
+        std::cout << "\nIndexes:\n";
+        for (const auto& pair : indexes) {
+            pair.second.print();
+        }
+        for (const auto& pair : prefix_indexes) {
+            pair.second.print();
+        }
+    }
+    
+    for (const auto& name : catalog.getTableNames()) {
+        const Table* table = catalog.getTable(name);
+        if (table->analyzed) {
+            std::cout << "\n";
+            table->printColumnStats();
+        }
+    }
+    
+    bool has_bloom = false;
+    for (const auto& name : catalog.getTableNames()) {
+        const Table* table = catalog.getTable(name);
+        for (const auto& column : table->bloom_columns) {
+            if (!has_bloom) {
+                std::cout << "\nBloom filters:\n";
+                has_bloom = true;
+            }
+            size_t filter_bytes = 0;
+            double estimated_fpr = 0.0;
+            int filters = 0;
+            for (int block_id : table->block_ids) {
+                auto block = all_blocks.find(block_id);
+                if (block == all_blocks.end()) continue;
+                auto filter = block->second->bloom_filters.find(column.first);
+                if (filter == block->second->bloom_filters.end()) continue;
+                filter_bytes += filter->second.getMemoryBytes();
+                estimated_fpr += filter->second.estimateFpr();
+                filters++;
             }
+            std::cout << "  " << name << "." << column.first << ": target FPR " 
+                      << column.second * 100 << "%, estimated FPR " 
+                      << (filters > 0 ? estimated_fpr / filters * 100 : 0.0) << "%, "
+                      << filters << " filters, " << filter_bytes << " bytes\n";
         }
     }
+    if (has_bloom) {
+        std::cout << "  Blocks probed: " << bloom_probes << ", skipped: " << bloom_skips
+                  << ", false positives (upper bound): " << bloom_false_positives;
+        if (bloom_skips + bloom_false_positives > 0) {
+            std::cout << " (observed FPR <= " 
+                      << 100.0 * bloom_false_positives / (bloom_skips + bloom_false_positives)
+                      << "%)";
+        }
+        std::cout << "\n";
+    }
+}
+
+void SGBD::printMemoryUsage() {
+    BufferManager& buffer = disk_manager.getBufferManager();
     
-    std::cout << "Total records: " << total_records << "\n";
-    std::cout << "Active records: " << (total_records - deleted_records) << "\n";
-    std::cout << "Deleted records: " << deleted_records << "\n";
+    size_t block_metadata = all_blocks.bucket_count() * sizeof(void*);
+    for (const auto& pair : all_blocks) {
+        block_metadata += 2 * sizeof(void*) + sizeof(pair) + pair.second->getMetadataMemory();
+    }
+    size_t index_memory = 0;
+    for (const auto& pair : indexes) {
+        index_memory += pair.second.getMemoryUsage();
+    }
+    for (const auto& pair : prefix_indexes) {
+        index_memory += pair.second.getMemoryUsage();
+    }
+    size_t locator_memory = record_block.bucket_count() * sizeof(void*) + 
+                            record_block.size() * (sizeof(std::pair<const int, int>) + 
+                                                   2 * sizeof(void*));
+    size_t catalog_memory = 0;
+    for (const auto& name : catalog.getTableNames()) {
+        catalog_memory += catalog.getTable(name)->getMemoryUsage();
+    }
+    size_t frames_memory = buffer.getMetadataMemory();
+    size_t cache_memory = result_cache.getMemoryUsage();
+    size_t disk_memory = disk_manager.getMemoryUsage();
+    size_t total = buffer.getUsedBytes() + block_metadata + index_memory + 
+                   locator_memory + catalog_memory + frames_memory + cache_memory +
+                   disk_memory;
+    
+    std::cout << "\nMemory usage (" << total << " bytes):\n";
+    std::cout << "  Buffer pool records: " << buffer.getUsedBytes() << " bytes (budget " 
+              << buffer.getMaxBytes() << ", " << buffer.getResidentCount() << " of " 
+              << all_blocks.size() << " blocks resident)\n";
+    std::cout << "  Buffer frames: " << frames_memory << " bytes\n";
+    std::cout << "  Block metadata (zone maps, Bloom filters, extents): " 
+              << block_metadata << " bytes\n";
+    std::cout << "  Secondary indexes: " << index_memory << " bytes\n";
+    std::cout << "  Record locator: " << locator_memory << " bytes\n";
+    std::cout << "  Catalog and statistics: " << catalog_memory << " bytes\n";
+    std::cout << "  Result cache: " << cache_memory << " bytes\n";
+    std::cout << "  Simulated disk: " << disk_memory << " bytes (" 
+              << disk_manager.getMaterializedTracks() << " tracks materialized)\n";
 }
 
 void SGBD::simulateFullBlock() {
+    std::lock_guard<std::recursive_mutex> guard(latch);
     std::cout << "\n=== Simulating Full Block Scenario ===\n";
     
-    // Crear un bloque pequeño (solo 2 registros)
-    Block* small_block = new Block(999, 2);
-    
-    // Llenar el bloque
     std::map<std::string, std::string> data1 = {{"name", "Test1"}, {"value", "100"}};
     std::map<std::string, std::string> data2 = {{"name", "Test2"}, {"value", "200"}};
     
     Record r1(data1, 9001);
     Record r2(data2, 9002);
     
+    // Crear un bloque pequeño (solo caben 2 registros)
+    Block* small_block = new Block(999, Block::encodedSize(r1) + Block::encodedSize(r2));
+    
+    // Llenar el bloque
     small_block->addRecord(r1);
     small_block->addRecord(r2);
     
@@ -268,11 +1735,14 @@ void SGBD::simulateFullBlock() {
         std::cout << "Creating new block for overflow...\n";
         
         // Crear nuevo bloque para el registro overflow
-        Block* new_block = new Block(1000, 5);
-        if (new_block->addRecord(r3)) {
-            all_blocks[new_block->block_id] = new_block;
-            disk_manager.storeBlock(new_block);
+        Block* new_block = new Block(1000, disk_manager.getBlockSize(), fill_factor);
+        if (new_block->addRecord(r3) && disk_manager.storeBlock(new_block)) {
+            Table* table = getOrCreateTable("simulation");
+            attachBlock(table, new_block);
+            indexRecord(r3, new_block->block_id);
             std::cout << "Record added to new block successfully\n";
+        } else {
+            delete new_block;
         }
     }
     
@@ -280,11 +1750,12 @@ void SGBD::simulateFullBlock() {
 }
 
 void SGBD::simulateFullSectors() {
+    std::lock_guard<std::recursive_mutex> guard(latch);
     std::cout << "\n=== Simulating Full Sectors Scenario ===\n";
     
     // Crear muchos bloques para llenar sectores
     for (int i = 0; i < 20; ++i) {
-        Block* block = new Block(2000 + i, 3);
+        Block* block = new Block(2000 + i, disk_manager.getBlockSize(), fill_factor);
         
         // Llenar cada bloque con datos
         for (int j = 0; j < 3; ++j) {
@@ -302,7 +1773,11 @@ void SGBD::simulateFullSectors() {
         timer.start();
         
         if (disk_manager.storeBlock(block)) {
-            all_blocks[block->block_id] = block;
+            Table* table = getOrCreateTable("simulation");
+            attachBlock(table, block);
+            for (const auto& record : block->records) {
+                indexRecord(record, block->block_id);
+            }
         } else {
             double elapsed_time = timer.getElapsedTime();
             std::cout << "Sector full! Cannot store block " << block->block_id 
@@ -334,4 +1809,13 @@ void createHousingSample() {
     file << "604000,4,3,1960,5000,1,0,0\n";
     file << "510000,3,2,1680,8080,1,0,0\n";
     file.close();
-}
\ No newline at end of file
+}
+
+void createPortsSample() {
+    std::ofstream file("ports_sample.csv");
+    file << "Embarked,Port,Country\n";
+    file << "S,Southampton,England\n";
+    file << "C,Cherbourg,France\n";
+    file << "Q,Queenstown,Ireland\n";
+    file.close();
+}
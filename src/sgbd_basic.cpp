@@ -1,4 +1,5 @@
 #include "sgbd_basic.h"
+#include <algorithm>
 
 // ==================== TIMER ====================
 void Timer::start() {
@@ -16,11 +17,27 @@ PhysicalLocation::PhysicalLocation(int p, int s, int t, int sec, int pos)
     : platter_id(p), surface_id(s), track_id(t), sector_id(sec), position(pos) {}
 
 void PhysicalLocation::print() const {
-    std::cout << "Location - Platter: " << platter_id 
+    print(std::cout);
+}
+
+void PhysicalLocation::print(std::ostream& out) const {
+    out << "Location - Platter: " << platter_id 
+        << ", Surface: " << surface_id 
+        << ", Track: " << track_id 
+        << ", Sector: " << sector_id 
+        << ", Position: " << position << std::endl;
+}
+
+// ==================== EXTENT ====================
+Extent::Extent(int p, int s, int t, int start, int count)
+    : platter_id(p), surface_id(s), track_id(t), start_sector(start), sector_count(count) {}
+
+void Extent::print() const {
+    std::cout << "Extent - Platter: " << platter_id 
               << ", Surface: " << surface_id 
               << ", Track: " << track_id 
-              << ", Sector: " << sector_id 
-              << ", Position: " << position << std::endl;
+              << ", Sectors: " << start_sector << "-" << (start_sector + sector_count - 1)
+              << std::endl;
 }
 
 // ==================== RECORD ====================
@@ -71,7 +88,27 @@ Record Record::deserialize(const std::string& serialized_data) {
 }
 
 int Record::getSize() const {
-    return static_cast<int>(serialize().length());
+    // Longitud de serialize() sin construir la cadena: "id|del|" + "k:v;" por campo
+    int size = static_cast<int>(std::to_string(record_id).length()) + 3;
+    for (const auto& pair : data) {
+        size += static_cast<int>(pair.first.length() + pair.second.length()) + 2;
+    }
+    return size;
+}
+
+size_t Record::getHeapMemory() const {
+    // Cada entrada del mapa es un nodo del árbol con la pareja de cadenas
+    const size_t node_size = 4 * sizeof(void*) + sizeof(std::pair<const std::string, std::string>);
+    size_t bytes = data.size() * node_size;
+    for (const auto& pair : data) {
+        bytes += stringHeapMemory(pair.first) + stringHeapMemory(pair.second);
+    }
+    return bytes;
+}
+
+size_t stringHeapMemory(const std::string& text) {
+    static const size_t inline_capacity = std::string().capacity();
+    return (text.capacity() > inline_capacity) ? text.capacity() + 1 : 0;
 }
 
 void Record::print() const {
@@ -82,23 +119,35 @@ void Record::print() const {
 }
 
 // ==================== SECTOR ====================
-Sector::Sector(int id, int cap) : sector_id(id), capacity(cap), used_space(0) {
-    data.resize(capacity, '\0');
-}
+Sector::Sector(int id, int cap) 
+    : sector_id(id), capacity(cap), used_space(0), allocated(false) {}
 
 bool Sector::hasSpace(int required_space) const {
-    return (used_space + required_space) <= capacity;
+    return !allocated && (used_space + required_space) <= capacity;
+}
+
+bool Sector::isFree() const {
+    return !allocated && used_space == 0;
+}
+
+void Sector::clear() {
+    used_space = 0;
+    data.clear();
+}
+
+void Sector::release() {
+    used_space = 0;
+    std::vector<char>().swap(data);
 }
 
 bool Sector::writeData(const std::string& content, int& position) {
-    if (!hasSpace(content.length())) {
+    if (used_space + static_cast<int>(content.length()) > capacity) {
         return false;
     }
     
+    // La memoria crece con lo escrito, nunca hasta la capacidad completa
     position = used_space;
-    for (size_t i = 0; i < content.length(); ++i) {
-        data[used_space + i] = content[i];
-    }
+    data.insert(data.end(), content.begin(), content.end());
     used_space += content.length();
     return true;
 }
@@ -111,29 +160,134 @@ std::string Sector::readData(int position, int length) const {
     return std::string(data.begin() + position, data.begin() + position + length);
 }
 
+size_t Sector::getMemoryUsage() const {
+    return sizeof(Sector) + data.capacity();
+}
+
 void Sector::print() const {
     std::cout << "Sector " << sector_id << " - Used: " << used_space 
               << "/" << capacity << " bytes\n";
 }
 
 // ==================== TRACK ====================
-Track::Track(int id, int num_sectors, int sector_capacity) 
-    : track_id(id), sectors_per_track(num_sectors) {
-    for (int i = 0; i < num_sectors; ++i) {
+Track::Track(int id, int num_sectors, int sector_cap) 
+    : track_id(id), sectors_per_track(num_sectors), sector_capacity(sector_cap),
+      free_sectors(num_sectors) {}
+
+bool Track::isMaterialized() const {
+    return !sectors.empty();
+}
+
+void Track::materialize() {
+    if (isMaterialized()) return;
+    sectors.reserve(sectors_per_track);
+    for (int i = 0; i < sectors_per_track; ++i) {
         sectors.emplace_back(i, sector_capacity);
     }
 }
 
-Sector* Track::findSectorWithSpace(int required_space) {
-    for (auto& sector : sectors) {
-        if (sector.hasSpace(required_space)) {
-            return &sector;
+Sector& Track::getSector(int index) {
+    materialize();
+    return sectors[index];
+}
+
+const Sector* Track::peekSector(int index) const {
+    return isMaterialized() ? &sectors[index] : nullptr;
+}
+
+void Track::reserveSectors(int start, int count) {
+    materialize();
+    for (int i = start; i < start + count; ++i) {
+        if (!sectors[i].allocated) {
+            sectors[i].allocated = true;
+            free_sectors--;
+        }
+    }
+}
+
+void Track::releaseSectors(int start, int count) {
+    if (!isMaterialized()) return;
+    for (int i = start; i < start + count; ++i) {
+        sectors[i].release();
+        if (sectors[i].allocated) {
+            sectors[i].allocated = false;
+            free_sectors++;
         }
     }
-    return nullptr;
+    // Una pista que vuelve a quedar vacía deja de ocupar memoria
+    if (free_sectors == sectors_per_track && getUsedSpace() == 0) {
+        std::vector<Sector>().swap(sectors);
+    }
+}
+
+int Track::findFreeRun(int count) const {
+    if (!isMaterialized()) {
+        return (count <= sectors_per_track) ? 0 : -1;
+    }
+    if (free_sectors < count) {
+        return -1;  // Pista llena: no hace falta recorrer sus sectores
+    }
+    int run_start = 0;
+    int run_length = 0;
+    for (int i = 0; i < static_cast<int>(sectors.size()); ++i) {
+        if (sectors[i].isFree()) {
+            if (run_length == 0) run_start = i;
+            if (++run_length == count) return run_start;
+        } else {
+            run_length = 0;
+        }
+    }
+    return -1;
+}
+
+int Track::nextFreeRun(int from, int& start) const {
+    start = -1;
+    if (from >= sectors_per_track) {
+        return 0;
+    }
+    if (!isMaterialized()) {
+        start = from;
+        return sectors_per_track - from;
+    }
+    if (free_sectors == 0) {
+        return 0;
+    }
+    int i = from;
+    while (i < sectors_per_track && !sectors[i].isFree()) {
+        i++;
+    }
+    if (i == sectors_per_track) {
+        return 0;
+    }
+    start = i;
+    while (i < sectors_per_track && sectors[i].isFree()) {
+        i++;
+    }
+    return i - start;
+}
+
+long long Track::getUsedSpace() const {
+    long long used = 0;
+    for (const auto& sector : sectors) {
+        used += sector.used_space;
+    }
+    return used;
+}
+
+size_t Track::getMemoryUsage() const {
+    size_t memory = sizeof(Track);
+    for (const auto& sector : sectors) {
+        memory += sector.getMemoryUsage();
+    }
+    return memory;
 }
 
 void Track::print() const {
+    if (!isMaterialized()) {
+        std::cout << "Track " << track_id << " with " << sectors_per_track 
+                  << " sectors (untouched)\n";
+        return;
+    }
     std::cout << "Track " << track_id << " with " << sectors.size() << " sectors:\n";
     for (const auto& sector : sectors) {
         std::cout << "  ";
@@ -149,15 +303,6 @@ Surface::Surface(int id, int num_tracks, int sectors_per_track, int sector_capac
     }
 }
 
-Track* Surface::findTrackWithSpace(int required_space) {
-    for (auto& track : tracks) {
-        if (track.findSectorWithSpace(required_space) != nullptr) {
-            return &track;
-        }
-    }
-    return nullptr;
-}
-
 void Surface::print() const {
     std::cout << "Surface " << surface_id << " with " << tracks.size() << " tracks:\n";
     for (const auto& track : tracks) {
@@ -175,15 +320,6 @@ Platter::Platter(int id, int num_surfaces, int tracks_per_surface,
     }
 }
 
-Surface* Platter::findSurfaceWithSpace(int required_space) {
-    for (auto& surface : surfaces) {
-        if (surface.findTrackWithSpace(required_space) != nullptr) {
-            return &surface;
-        }
-    }
-    return nullptr;
-}
-
 void Platter::print() const {
     std::cout << "Platter " << platter_id << " with " << surfaces.size() << " surfaces:\n";
     for (const auto& surface : surfaces) {
@@ -0,0 +1,334 @@
+#include "protocol.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <random>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Generador de carga para sgbd_server: abre muchas conexiones, mantiene en
+// cada una hasta 'depth' peticiones en vuelo (pipelining) y mide el
+// rendimiento y la latencia de cola.
+//
+// Uso: sgbd_loadgen [-s socket] [-c conexiones] [-d profundidad] [-n peticiones]
+//                   [-m ping|query|insert|mixed] [-p filas_precargadas] [-k claves]
+
+using protocol::Opcode;
+using protocol::Request;
+using protocol::Response;
+using protocol::Status;
+
+typedef std::chrono::steady_clock Clock;
+
+struct LoadConfig {
+    std::string socket_path;
+    int connections;
+    int depth;
+    long long requests;
+    std::string mix;
+    long long preload_rows;
+    int key_count;
+    std::string table;
+
+    LoadConfig()
+        : socket_path("/tmp/sgbd.sock"), connections(64), depth(16), requests(100000),
+          mix("mixed"), preload_rows(2000), key_count(200), table("loadgen") {}
+};
+
+struct ClientConnection {
+    int fd;
+    std::string input;
+    size_t input_offset;
+    std::string output;
+    size_t output_offset;
+    bool want_write;
+    std::deque<std::pair<uint32_t, Clock::time_point>> in_flight;
+
+    ClientConnection() : fd(-1), input_offset(0), output_offset(0), want_write(false) {}
+};
+
+struct PhaseResult {
+    long long completed;
+    long long errors;
+    long long rows_returned;
+    double elapsed_seconds;
+    std::vector<double> latencies_us;
+    bool timed_out;
+
+    PhaseResult() : completed(0), errors(0), rows_returned(0), elapsed_seconds(0), timed_out(false) {}
+};
+
+class LoadGenerator {
+private:
+    LoadConfig config;
+    std::mt19937_64 rng;
+    uint32_t next_request_id;
+
+    void makeRequest(const std::string& mix, Request& request) {
+        request = Request();
+        request.request_id = next_request_id++;
+        request.table = config.table;
+
+        std::string key = std::to_string(rng() % static_cast<uint64_t>(config.key_count));
+        std::string kind = mix;
+        if (mix == "mixed") {
+            // 90% lecturas por igualdad, 10% inserciones
+            kind = (rng() % 10 == 0) ? "insert" : "query";
+        }
+
+        if (kind == "ping") {
+            request.opcode = Opcode::PING;
+        } else if (kind == "insert") {
+            request.opcode = Opcode::INSERT;
+            request.fields["user"] = key;
+            request.fields["value"] = std::to_string(rng() % 100000);
+        } else {
+            request.opcode = Opcode::QUERY;
+            request.text = "user = '" + key + "'";
+            request.limit = 10;
+        }
+    }
+
+    bool connectAll(std::vector<ClientConnection>& clients, int epoll_fd) {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, config.socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+        for (auto& client : clients) {
+            client.fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (client.fd < 0 ||
+                connect(client.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+                std::cout << "Error: connect to " << config.socket_path << ": "
+                          << std::strerror(errno) << "\n";
+                return false;
+            }
+            fcntl(client.fd, F_SETFL, fcntl(client.fd, F_GETFL) | O_NONBLOCK);
+
+            epoll_event event;
+            std::memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            event.data.ptr = &client;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client.fd, &event);
+        }
+        return true;
+    }
+
+    // Escribir lo pendiente; devuelve false si la conexión se rompió
+    bool flush(ClientConnection& client, int epoll_fd) {
+        while (client.output_offset < client.output.size()) {
+            ssize_t sent = send(client.fd, client.output.data() + client.output_offset,
+                                client.output.size() - client.output_offset, MSG_NOSIGNAL);
+            if (sent > 0) {
+                client.output_offset += static_cast<size_t>(sent);
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            return false;
+        }
+        if (client.output_offset == client.output.size()) {
+            client.output.clear();
+            client.output_offset = 0;
+        }
+
+        bool want_write = !client.output.empty();
+        if (want_write != client.want_write) {
+            epoll_event event;
+            std::memset(&event, 0, sizeof(event));
+            event.events = want_write ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+            event.data.ptr = &client;
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, client.fd, &event);
+            client.want_write = want_write;
+        }
+        return true;
+    }
+
+    // Mantener la tubería llena mientras queden peticiones por emitir
+    void topUp(ClientConnection& client, const std::string& mix, long long& issued, long long total) {
+        Request request;
+        while (issued < total && static_cast<int>(client.in_flight.size()) < config.depth) {
+            makeRequest(mix, request);
+            protocol::encodeRequest(request, client.output);
+            client.in_flight.emplace_back(request.request_id, Clock::now());
+            issued++;
+        }
+    }
+
+    bool readResponses(ClientConnection& client, PhaseResult& result) {
+        char chunk[64 * 1024];
+        while (true) {
+            ssize_t received = recv(client.fd, chunk, sizeof(chunk), 0);
+            if (received > 0) {
+                client.input.append(chunk, static_cast<size_t>(received));
+                continue;
+            }
+            if (received < 0 && errno == EINTR) continue;
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            std::cout << "Error: server closed the connection\n";
+            return false;
+        }
+
+        const char* payload = nullptr;
+        uint32_t length = 0;
+        int status;
+        Clock::time_point now = Clock::now();
+        while ((status = protocol::nextFrame(client.input, client.input_offset, payload, length)) == 1) {
+            Response response;
+            if (!protocol::decodeResponse(payload, length, response) || client.in_flight.empty() ||
+                client.in_flight.front().first != response.request_id) {
+                std::cout << "Error: unexpected response from server\n";
+                return false;
+            }
+            std::chrono::duration<double, std::micro> latency = now - client.in_flight.front().second;
+            client.in_flight.pop_front();
+
+            result.latencies_us.push_back(latency.count());
+            result.completed++;
+            result.rows_returned += response.records.size();
+            if (response.status == Status::ERROR) {
+                result.errors++;
+            }
+        }
+        if (status < 0) {
+            std::cout << "Error: oversized response frame\n";
+            return false;
+        }
+        if (client.input_offset == client.input.size()) {
+            client.input.clear();
+            client.input_offset = 0;
+        }
+        return true;
+    }
+
+public:
+    explicit LoadGenerator(const LoadConfig& load_config)
+        : config(load_config), rng(42), next_request_id(1) {}
+
+    bool runPhase(const std::string& mix, long long total, int connection_count, PhaseResult& result) {
+        int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        std::vector<ClientConnection> clients(static_cast<size_t>(connection_count));
+        if (epoll_fd < 0 || !connectAll(clients, epoll_fd)) {
+            for (auto& client : clients) {
+                if (client.fd >= 0) close(client.fd);
+            }
+            if (epoll_fd >= 0) close(epoll_fd);
+            return false;
+        }
+
+        Timer timer;
+        timer.start();
+        long long issued = 0;
+        bool ok = true;
+        for (auto& client : clients) {
+            topUp(client, mix, issued, total);
+            ok = ok && flush(client, epoll_fd);
+        }
+
+        std::vector<epoll_event> events(static_cast<size_t>(connection_count));
+        while (ok && result.completed < total) {
+            int ready = epoll_wait(epoll_fd, events.data(), connection_count, 10000);
+            if (ready < 0 && errno == EINTR) continue;
+            if (ready <= 0) {
+                result.timed_out = true;
+                break;
+            }
+            for (int i = 0; i < ready && ok; ++i) {
+                ClientConnection& client = *static_cast<ClientConnection*>(events[i].data.ptr);
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    ok = readResponses(client, result);
+                    topUp(client, mix, issued, total);
+                }
+                ok = ok && flush(client, epoll_fd);
+            }
+        }
+        result.elapsed_seconds = timer.getElapsedTime() / 1000.0;
+
+        for (auto& client : clients) {
+            close(client.fd);
+        }
+        close(epoll_fd);
+        return ok && !result.timed_out;
+    }
+};
+
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    size_t position = static_cast<size_t>(fraction * (sorted.size() - 1));
+    return sorted[position];
+}
+
+static void printResult(const std::string& label, const LoadConfig& config, PhaseResult& result) {
+    std::sort(result.latencies_us.begin(), result.latencies_us.end());
+    double throughput = (result.elapsed_seconds > 0) ? result.completed / result.elapsed_seconds : 0;
+
+    std::cout << "=== " << label << " ===\n";
+    std::cout << "Requests: " << result.completed << " over " << config.connections
+              << " connections (pipeline depth " << config.depth << ") in "
+              << result.elapsed_seconds << " s\n";
+    std::cout << "Throughput: " << static_cast<long long>(throughput) << " requests/s\n";
+    std::cout << "Latency (us): p50 " << percentile(result.latencies_us, 0.50)
+              << ", p90 " << percentile(result.latencies_us, 0.90)
+              << ", p99 " << percentile(result.latencies_us, 0.99)
+              << ", p99.9 " << percentile(result.latencies_us, 0.999)
+              << ", max " << (result.latencies_us.empty() ? 0 : result.latencies_us.back()) << "\n";
+    std::cout << "Rows returned: " << result.rows_returned << ", errors: " << result.errors << "\n";
+}
+
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [-s socket_path] [-c connections] [-d depth] "
+              << "[-n requests] [-m ping|query|insert|mixed] [-p preload_rows] [-k keys]\n";
+}
+
+int main(int argc, char* argv[]) {
+    LoadConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "-s") config.socket_path = value;
+        else if (arg == "-c") config.connections = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "-d") config.depth = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "-n") config.requests = std::max(1LL, std::atoll(value.c_str()));
+        else if (arg == "-m") config.mix = value;
+        else if (arg == "-p") config.preload_rows = std::max(0LL, std::atoll(value.c_str()));
+        else if (arg == "-k") config.key_count = std::max(1, std::atoi(value.c_str()));
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.mix != "ping" && config.mix != "query" && config.mix != "insert" &&
+        config.mix != "mixed") {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    LoadGenerator generator(config);
+
+    // Las consultas necesitan datos: se precargan con inserciones en tubería
+    if (config.preload_rows > 0 && (config.mix == "query" || config.mix == "mixed")) {
+        PhaseResult preload;
+        if (!generator.runPhase("insert", config.preload_rows, 1, preload)) {
+            return 1;
+        }
+        std::cout << "Preloaded " << preload.completed << " rows into '" << config.table
+                  << "' in " << preload.elapsed_seconds << " s (" << preload.errors << " errors)\n";
+    }
+
+    PhaseResult result;
+    bool ok = generator.runPhase(config.mix, config.requests, config.connections, result);
+    printResult("Load: " + config.mix, config, result);
+    if (result.timed_out) {
+        std::cout << "Error: timed out waiting for responses\n";
+    }
+    return ok ? 0 : 1;
+}
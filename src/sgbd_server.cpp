@@ -0,0 +1,93 @@
+#include "server.h"
+#include <csignal>
+#include <cstdlib>
+
+// Servidor del SGBD: comparte una instancia entre varios procesos locales.
+//
+// Uso: sgbd_server [-s socket] [-b buffer_kb] [-c cache_kb] [-w writer_kb_s] [-v]
+//                   [tabla=fichero.csv ...]
+
+static SGBDServer* active_server = nullptr;
+
+static void handleSignal(int) {
+    if (active_server != nullptr) {
+        active_server->stop();
+    }
+}
+
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program
+              << " [-s socket_path] [-b buffer_kb] [-c cache_kb] [-w writer_kb_s] [-v]"
+              << " [table=file.csv ...]\n"
+              << "  -s  Unix domain socket path (default /tmp/sgbd.sock)\n"
+              << "  -b  Buffer pool budget in KB (default 16384)\n"
+              << "  -c  Result cache capacity in KB (default 0, disabled)\n"
+              << "  -w  Background writer budget in KB/s (default 0, no background writer)\n"
+              << "  -v  Print the engine messages of every request\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string socket_path = "/tmp/sgbd.sock";
+    size_t buffer_kb = 16384;
+    size_t cache_kb = 0;
+    size_t writer_kb = 0;
+    bool verbose = false;
+    std::vector<std::pair<std::string, std::string>> csv_files;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "-s" || arg == "-b" || arg == "-c" || arg == "-w") && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (arg == "-s") socket_path = value;
+            else if (arg == "-b") buffer_kb = std::strtoul(value.c_str(), nullptr, 10);
+            else if (arg == "-c") cache_kb = std::strtoul(value.c_str(), nullptr, 10);
+            else writer_kb = std::strtoul(value.c_str(), nullptr, 10);
+        } else if (arg == "-v") {
+            verbose = true;
+        } else if (arg.find('=') != std::string::npos) {
+            size_t equals = arg.find('=');
+            csv_files.emplace_back(arg.substr(0, equals), arg.substr(equals + 1));
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Disco de 32 MB: 2 platos, 2 superficies, 64 pistas, 32 sectores de 4 KB,
+    // con bloques de 8 KB llenados hasta el 90%
+    SGBD system(2, 2, 64, 32, 4096, buffer_kb * 1024, 8192, 0.9);
+    for (const auto& file : csv_files) {
+        system.loadFromCSV(file.second, file.first);
+    }
+    if (cache_kb > 0) {
+        system.setResultCacheCapacity(cache_kb * 1024);
+    }
+    if (writer_kb > 0) {
+        system.startBackgroundWriter(WriterConfig(writer_kb * 1024));
+    }
+
+    SGBDServer server(system, socket_path, verbose);
+    std::string error;
+    if (!server.start(error)) {
+        std::cout << "Error: " << error << "\n";
+        return 1;
+    }
+
+    active_server = &server;
+    struct sigaction action;
+    action.sa_handler = handleSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "SGBD server listening on " << socket_path << "\n";
+    server.run();
+    active_server = nullptr;
+
+    std::cout << "\nShutting down\n";
+    server.printStats();
+    system.showSystemStats();
+    return 0;
+}
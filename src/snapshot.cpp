@@ -0,0 +1,357 @@
+#include "snapshot.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char SNAPSHOT_MAGIC[8] = {'S', 'G', 'B', 'D', 'S', 'N', 'A', 'P'};
+// Cabecera: firma, versión, número de secciones y checksum de la tabla
+static const size_t HEADER_BYTES = 8 + 4 + 4 + 8;
+// Entrada de la tabla: id, posición, tamaño y checksum
+static const size_t ENTRY_BYTES = 4 + 8 + 8 + 8;
+
+// ==================== SNAPSHOT WRITER ====================
+SnapshotWriter::SnapshotWriter(std::string& buffer) : out(buffer) {}
+
+void SnapshotWriter::putU8(uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+void SnapshotWriter::putU32(uint32_t value) {
+    char bytes[4];
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+    out.append(bytes, 4);
+}
+
+void SnapshotWriter::putU64(uint64_t value) {
+    char bytes[8];
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+    out.append(bytes, 8);
+}
+
+void SnapshotWriter::putI32(int value) {
+    putU32(static_cast<uint32_t>(value));
+}
+
+void SnapshotWriter::putI64(long long value) {
+    putU64(static_cast<uint64_t>(value));
+}
+
+void SnapshotWriter::putDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU64(bits);
+}
+
+void SnapshotWriter::putString(const std::string& value) {
+    putU32(static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+void SnapshotWriter::putBytes(const char* data, size_t length) {
+    out.append(data, length);
+}
+
+// ==================== SNAPSHOT READER ====================
+SnapshotReader::SnapshotReader(const char* bytes, size_t length)
+    : data(bytes), size(length), pos(0) {}
+
+bool SnapshotReader::getU8(uint8_t& value) {
+    if (size - pos < 1) return false;
+    value = static_cast<uint8_t>(data[pos++]);
+    return true;
+}
+
+bool SnapshotReader::getU32(uint32_t& value) {
+    if (size - pos < 4) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+    }
+    pos += 4;
+    return true;
+}
+
+bool SnapshotReader::getU64(uint64_t& value) {
+    if (size - pos < 8) return false;
+    value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+    }
+    pos += 8;
+    return true;
+}
+
+bool SnapshotReader::getI32(int& value) {
+    uint32_t raw;
+    if (!getU32(raw)) return false;
+    value = static_cast<int>(raw);
+    return true;
+}
+
+bool SnapshotReader::getI64(long long& value) {
+    uint64_t raw;
+    if (!getU64(raw)) return false;
+    value = static_cast<long long>(raw);
+    return true;
+}
+
+bool SnapshotReader::getDouble(double& value) {
+    uint64_t bits;
+    if (!getU64(bits)) return false;
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+bool SnapshotReader::getBool(bool& value) {
+    uint8_t raw;
+    if (!getU8(raw) || raw > 1) return false;
+    value = (raw == 1);
+    return true;
+}
+
+bool SnapshotReader::getString(std::string& value) {
+    uint32_t length;
+    if (!getU32(length) || size - pos < length) return false;
+    value.assign(data + pos, length);
+    pos += length;
+    return true;
+}
+
+bool SnapshotReader::getBytes(const char*& bytes, size_t length) {
+    if (size - pos < length) return false;
+    bytes = data + pos;
+    pos += length;
+    return true;
+}
+
+bool SnapshotReader::getCount(uint32_t& count, size_t min_element_bytes) {
+    if (!getU32(count)) return false;
+    return min_element_bytes == 0 || count <= (size - pos) / min_element_bytes;
+}
+
+bool SnapshotReader::atEnd() const {
+    return pos == size;
+}
+
+// ==================== CHECKSUM ====================
+uint64_t snapshotChecksum(const char* data, size_t length) {
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+    uint64_t hash = 0xCBF29CE484222325ULL ^ (length * multiplier);
+    
+    size_t pos = 0;
+    for (; pos + 8 <= length; pos += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + pos, sizeof(word));
+        hash = (hash ^ (word * multiplier)) * 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 29;
+    }
+    uint64_t tail = 0;
+    for (size_t i = 0; pos + i < length; ++i) {
+        tail |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+    }
+    hash = (hash ^ (tail * multiplier)) * 0xFF51AFD7ED558CCDULL;
+    
+    // Mezcla final (fmix64 de MurmurHash3)
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// ==================== SNAPSHOT FILE ====================
+SnapshotFile::SnapshotFile() : fd(-1), base(nullptr), length(0) {}
+
+SnapshotFile::~SnapshotFile() {
+    close();
+}
+
+static bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = ::write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool SnapshotFile::write(const std::string& path,
+                         const std::vector<std::pair<SnapshotSection, std::string>>& sections,
+                         std::string& error) {
+    // Cabecera y tabla de secciones; las secciones empiezan alineadas a 8 bytes
+    std::string table;
+    SnapshotWriter table_writer(table);
+    uint64_t offset = HEADER_BYTES + ENTRY_BYTES * sections.size();
+    std::vector<uint64_t> padding;
+    for (const auto& section : sections) {
+        table_writer.putU32(static_cast<uint32_t>(section.first));
+        table_writer.putU64(offset);
+        table_writer.putU64(section.second.size());
+        table_writer.putU64(snapshotChecksum(section.second.data(), section.second.size()));
+        offset += section.second.size();
+        padding.push_back((8 - offset % 8) % 8);
+        offset += padding.back();
+    }
+    
+    std::string header;
+    SnapshotWriter header_writer(header);
+    header_writer.putBytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header_writer.putU32(FORMAT_VERSION);
+    header_writer.putU32(static_cast<uint32_t>(sections.size()));
+    header_writer.putU64(snapshotChecksum(table.data(), table.size()));
+    
+    std::string temporary = path + ".tmp";
+    int out = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        error = "cannot create " + temporary + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    bool ok = writeAll(out, header.data(), header.size()) &&
+              writeAll(out, table.data(), table.size());
+    for (size_t i = 0; ok && i < sections.size(); ++i) {
+        ok = writeAll(out, sections[i].second.data(), sections[i].second.size()) &&
+             writeAll(out, zeros, static_cast<size_t>(padding[i]));
+    }
+    ok = ok && fsync(out) == 0;
+    int saved_errno = errno;
+    ok = (::close(out) == 0) && ok;
+    
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        error = "cannot write " + path + ": " + std::strerror(ok ? errno : saved_errno);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SnapshotFile::open(const std::string& file_path, std::string& error) {
+    close();
+    path = file_path;
+    
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length < HEADER_BYTES) {
+        error = path + " is not a snapshot (too short)";
+        close();
+        return false;
+    }
+    
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        error = "cannot map " + path + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    base = static_cast<const char*>(mapping);
+    // Las secciones se leen enteras, en orden, justo después de abrir
+    madvise(mapping, length, MADV_WILLNEED);
+    
+    SnapshotReader header(base, HEADER_BYTES);
+    const char* magic = nullptr;
+    uint32_t version = 0;
+    uint32_t count = 0;
+    uint64_t table_checksum = 0;
+    header.getBytes(magic, sizeof(SNAPSHOT_MAGIC));
+    header.getU32(version);
+    header.getU32(count);
+    header.getU64(table_checksum);
+    
+    std::string problem;
+    if (std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        problem = path + " is not a snapshot (bad signature)";
+    } else if (version != FORMAT_VERSION) {
+        problem = path + " has snapshot format version " + std::to_string(version) +
+                ", expected " + std::to_string(FORMAT_VERSION);
+    } else if (count > (length - HEADER_BYTES) / ENTRY_BYTES) {
+        problem = path + " is truncated (section table)";
+    } else if (snapshotChecksum(base + HEADER_BYTES, count * ENTRY_BYTES) != table_checksum) {
+        problem = path + " has a corrupt section table";
+    }
+    if (!problem.empty()) {
+        error = problem;
+        close();
+        return false;
+    }
+    
+    SnapshotReader table(base + HEADER_BYTES, count * ENTRY_BYTES);
+    for (uint32_t i = 0; i < count; ++i) {
+        Entry entry;
+        table.getU32(entry.id);
+        table.getU64(entry.offset);
+        table.getU64(entry.length);
+        table.getU64(entry.checksum);
+        if (entry.offset > length || entry.length > length - entry.offset) {
+            error = path + " is truncated (section " + std::to_string(entry.id) + ")";
+            close();
+            return false;
+        }
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+void SnapshotFile::close() {
+    if (base != nullptr) {
+        munmap(const_cast<char*>(base), length);
+        base = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    length = 0;
+    entries.clear();
+}
+
+bool SnapshotFile::hasSection(SnapshotSection id) const {
+    for (const auto& entry : entries) {
+        if (entry.id == static_cast<uint32_t>(id)) return true;
+    }
+    return false;
+}
+
+bool SnapshotFile::openSection(SnapshotSection id, SnapshotReader& reader, std::string& error) const {
+    for (const auto& entry : entries) {
+        if (entry.id != static_cast<uint32_t>(id)) continue;
+        
+        const char* data = base + entry.offset;
+        size_t size = static_cast<size_t>(entry.length);
+        if (snapshotChecksum(data, size) != entry.checksum) {
+            error = "checksum mismatch in section " + std::to_string(entry.id) + " of " + path;
+            return false;
+        }
+        reader = SnapshotReader(data, size);
+        return true;
+    }
+    error = "section " + std::to_string(static_cast<uint32_t>(id)) + " missing from " + path;
+    return false;
+}
+
+const std::string& SnapshotFile::getPath() const {
+    return path;
+}
+
+size_t SnapshotFile::getSize() const {
+    return length;
+}
@@ -0,0 +1,250 @@
+#include "sort.h"
+#include <queue>
+
+// ==================== SORT KEY ====================
+SortKey::SortKey(const std::string& attr, bool asc) : attribute(attr), ascending(asc) {}
+
+bool SortKey::parseList(const std::string& text, std::vector<SortKey>& keys) {
+    keys.clear();
+    std::istringstream list(text);
+    std::string item;
+    
+    while (std::getline(list, item, ',')) {
+        std::istringstream words(item);
+        std::string attribute, direction, extra;
+        words >> attribute >> direction >> extra;
+        if (attribute.empty() || !extra.empty()) {
+            return false;
+        }
+        
+        for (auto& c : direction) {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        if (direction.empty() || direction == "ASC") {
+            keys.emplace_back(attribute, true);
+        } else if (direction == "DESC") {
+            keys.emplace_back(attribute, false);
+        } else {
+            return false;
+        }
+    }
+    return !keys.empty();
+}
+
+// ==================== RUN READER ====================
+// Lector secuencial de un run: carga una página cada vez
+class SortOperator::RunReader {
+private:
+    const SpillFile* run;
+    int next_page;
+    std::string buffer;
+    size_t pos;
+    
+public:
+    explicit RunReader(const SpillFile* spill) : run(spill), next_page(0), pos(0) {}
+    
+    bool next(Record& record) {
+        size_t end = buffer.find('\n', pos);
+        while (end == std::string::npos) {
+            std::string page;
+            if (!run->readPage(next_page, page)) {
+                return false;
+            }
+            next_page++;
+            buffer.erase(0, pos);
+            pos = 0;
+            buffer += page;
+            end = buffer.find('\n', pos);
+        }
+        record = Record::deserialize(buffer.substr(pos, end - pos));
+        pos = end + 1;
+        return true;
+    }
+};
+
+// ==================== SORT OPERATOR ====================
+SortOperator::SortOperator(DiskManager* disk_manager, const std::vector<SortKey>& sort_keys,
+                           long long budget_bytes, size_t max_rows)
+    : disk(disk_manager), keys(sort_keys), memory_budget(budget_bytes), 
+      limit(max_rows), runs_spilled(0), merge_passes(0) {}
+
+bool SortOperator::less(const Record& a, const Record& b) const {
+    static const std::string missing;
+    for (const auto& key : keys) {
+        auto it_a = a.data.find(key.attribute);
+        auto it_b = b.data.find(key.attribute);
+        // Los valores ausentes se ordenan como cadena vacía (primero en ASC);
+        // el resto sigue orderValues, que sí es un orden estricto débil
+        const std::string& value_a = (it_a != a.data.end()) ? it_a->second : missing;
+        const std::string& value_b = (it_b != b.data.end()) ? it_b->second : missing;
+        
+        int cmp = (value_a.empty() || value_b.empty()) 
+            ? static_cast<int>(!value_a.empty()) - static_cast<int>(!value_b.empty())
+            : orderValues(value_a, value_b);
+        if (cmp != 0) {
+            return key.ascending ? cmp < 0 : cmp > 0;
+        }
+    }
+    return a.record_id < b.record_id;  // Orden estable y determinista
+}
+
+bool SortOperator::spillRun(std::vector<Record>& run, 
+                            std::vector<std::unique_ptr<SpillFile>>& runs) {
+    std::sort(run.begin(), run.end(), 
+              [this](const Record& a, const Record& b) { return less(a, b); });
+    
+    std::unique_ptr<SpillFile> spill(new SpillFile(disk));
+    for (const auto& record : run) {
+        if (!spill->append(record.serialize() + "\n")) return false;
+    }
+    if (!spill->flush()) return false;
+    
+    runs.push_back(std::move(spill));
+    runs_spilled++;
+    run.clear();
+    return true;
+}
+
+bool SortOperator::mergeRuns(std::vector<std::unique_ptr<SpillFile>>& runs,
+                             const std::function<bool(const Record&)>& consumer,
+                             SpillFile* output) {
+    std::vector<RunReader> readers;
+    for (const auto& run : runs) {
+        readers.emplace_back(run.get());
+    }
+    
+    // Heap de mínimos con el registro actual de cada run
+    typedef std::pair<Record, size_t> HeapEntry;
+    auto greater = [this](const HeapEntry& a, const HeapEntry& b) {
+        return less(b.first, a.first);
+    };
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(greater)> heap(greater);
+    
+    for (size_t i = 0; i < readers.size(); ++i) {
+        Record record;
+        if (readers[i].next(record)) {
+            heap.emplace(record, i);
+        }
+    }
+    
+    while (!heap.empty()) {
+        HeapEntry top = heap.top();
+        heap.pop();
+        
+        if (output != nullptr) {
+            if (!output->append(top.first.serialize() + "\n")) return false;
+        } else if (!consumer(top.first)) {
+            return true;
+        }
+        
+        Record record;
+        if (readers[top.second].next(record)) {
+            heap.emplace(record, top.second);
+        }
+    }
+    return output == nullptr || output->flush();
+}
+
+bool SortOperator::execute(const std::vector<Block*>& blocks, const Predicate& filter,
+                           const std::function<bool(const Record&)>& consumer) {
+    runs_spilled = 0;
+    merge_passes = 0;
+    auto record_less = [this](const Record& a, const Record& b) { return less(a, b); };
+    
+    // ORDER BY ... LIMIT k: heap acotado con los k mejores registros
+    if (limit > 0) {
+        std::priority_queue<Record, std::vector<Record>, decltype(record_less)> heap(record_less);
+        for (Block* block : blocks) {
+            BlockPin pin(disk->getBufferManager(), block);
+            if (pin.get() == nullptr) return false;
+            for (const auto& record : block->records) {
+                if (record.is_deleted || !filter.evaluate(record)) continue;
+                if (heap.size() < limit) {
+                    heap.push(record);
+                } else if (less(record, heap.top())) {
+                    heap.pop();
+                    heap.push(record);
+                }
+            }
+        }
+        
+        std::vector<Record> top;
+        top.reserve(heap.size());
+        while (!heap.empty()) {
+            top.push_back(heap.top());
+            heap.pop();
+        }
+        for (auto it = top.rbegin(); it != top.rend(); ++it) {
+            if (!consumer(*it)) break;
+        }
+        return true;
+    }
+    
+    // Generación de runs: acumular hasta agotar el presupuesto de memoria.
+    // Cada registro se contabiliza por lo que ocupa en memoria (el objeto y
+    // su mapa), no por su tamaño codificado, que es bastante menor.
+    std::vector<Record> run;
+    std::vector<std::unique_ptr<SpillFile>> runs;
+    long long run_bytes = 0;
+    
+    for (Block* block : blocks) {
+        BlockPin pin(disk->getBufferManager(), block);
+        if (pin.get() == nullptr) return false;
+        for (const auto& record : block->records) {
+            if (record.is_deleted || !filter.evaluate(record)) continue;
+            run.push_back(record);
+            run_bytes += static_cast<long long>(sizeof(Record) + record.getHeapMemory());
+            if (run_bytes > memory_budget) {
+                if (!spillRun(run, runs)) return false;
+                run_bytes = 0;
+            }
+        }
+    }
+    
+    // Todo cupo en memoria: ordenación interna
+    if (runs.empty()) {
+        std::sort(run.begin(), run.end(), record_less);
+        for (const auto& record : run) {
+            if (!consumer(record)) break;
+        }
+        return true;
+    }
+    
+    if (!run.empty() && !spillRun(run, runs)) return false;
+    
+    // Cada run abierto necesita una página en memoria: limitar el fan-in.
+    // Cada pasada combina todos los runs en grupos de fan_in; la última
+    // entrega el resultado al consumidor.
+    size_t fan_in = static_cast<size_t>(
+        std::max(2, static_cast<int>(memory_budget / disk->getBlockSize()) - 1));
+    while (runs.size() > fan_in) {
+        std::vector<std::unique_ptr<SpillFile>> next_pass;
+        for (size_t begin = 0; begin < runs.size(); begin += fan_in) {
+            size_t end = std::min(runs.size(), begin + fan_in);
+            if (end - begin == 1) {
+                next_pass.push_back(std::move(runs[begin]));
+                continue;
+            }
+            std::vector<std::unique_ptr<SpillFile>> group;
+            for (size_t i = begin; i < end; ++i) {
+                group.push_back(std::move(runs[i]));
+            }
+            std::unique_ptr<SpillFile> merged(new SpillFile(disk));
+            if (!mergeRuns(group, consumer, merged.get())) return false;
+            next_pass.push_back(std::move(merged));
+        }
+        runs = std::move(next_pass);
+        merge_passes++;
+    }
+    
+    merge_passes++;
+    return mergeRuns(runs, consumer, nullptr);
+}
+
+int SortOperator::getRunCount() const {
+    return runs_spilled;
+}
+
+int SortOperator::getMergePasses() const {
+    return merge_passes;
+}
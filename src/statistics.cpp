@@ -0,0 +1,368 @@
+#include "statistics.h"
+#include <algorithm>
+#include <cmath>
+
+// ==================== HYPERLOGLOG ====================
+HyperLogLog::HyperLogLog() : registers(REGISTERS, 0) {}
+
+void HyperLogLog::add(const std::string& value) {
+    uint64_t hash = hashValue(value);
+    size_t index = static_cast<size_t>(hash >> (64 - PRECISION));
+    // Bit centinela para que el rango quede acotado a 64 - PRECISION + 1
+    uint64_t remaining = (hash << PRECISION) | (1ULL << (PRECISION - 1));
+    uint8_t rank = static_cast<uint8_t>(__builtin_clzll(remaining) + 1);
+    if (rank > registers[index]) {
+        registers[index] = rank;
+    }
+}
+
+void HyperLogLog::clear() {
+    std::fill(registers.begin(), registers.end(), 0);
+}
+
+double HyperLogLog::estimate() const {
+    double sum = 0.0;
+    int zeros = 0;
+    for (uint8_t reg : registers) {
+        sum += std::ldexp(1.0, -reg);
+        if (reg == 0) zeros++;
+    }
+    double m = REGISTERS;
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    
+    // Corrección para cardinalidades pequeñas (linear counting)
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / zeros);
+    }
+    return estimate;
+}
+
+size_t HyperLogLog::getMemoryUsage() const {
+    return registers.capacity() * sizeof(uint8_t);
+}
+
+void HyperLogLog::save(SnapshotWriter& out) const {
+    out.putBytes(reinterpret_cast<const char*>(registers.data()), registers.size());
+}
+
+bool HyperLogLog::load(SnapshotReader& in) {
+    const char* bytes;
+    if (!in.getBytes(bytes, REGISTERS)) return false;
+    registers.assign(reinterpret_cast<const uint8_t*>(bytes),
+                     reinterpret_cast<const uint8_t*>(bytes) + REGISTERS);
+    return true;
+}
+
+// ==================== EQUI-DEPTH HISTOGRAM ====================
+EquiDepthHistogram::EquiDepthHistogram() : numeric(true), total(0) {}
+
+void EquiDepthHistogram::build(const std::vector<std::string>& values, int max_buckets) {
+    buckets.clear();
+    total = static_cast<long long>(values.size());
+    numeric = true;
+    if (values.empty() || max_buckets <= 0) {
+        lower.clear();
+        return;
+    }
+    
+    double number;
+    for (const auto& value : values) {
+        if (!parseNumber(value, number)) {
+            numeric = false;
+            break;
+        }
+    }
+    
+    lower = values.front();
+    size_t per_bucket = (values.size() + max_buckets - 1) / max_buckets;
+    size_t start = 0;
+    while (start < values.size()) {
+        size_t end = std::min(values.size(), start + per_bucket);
+        // Un mismo valor nunca se reparte entre dos cubetas
+        while (end < values.size() && orderValues(values[end], values[end - 1]) == 0) {
+            end++;
+        }
+        
+        Bucket bucket;
+        bucket.upper = values[end - 1];
+        bucket.count = static_cast<long long>(end - start);
+        bucket.distinct = 1;
+        for (size_t i = start + 1; i < end; ++i) {
+            if (orderValues(values[i], values[i - 1]) != 0) {
+                bucket.distinct++;
+            }
+        }
+        buckets.push_back(bucket);
+        start = end;
+    }
+}
+
+int EquiDepthHistogram::findBucket(const std::string& value) const {
+    // Primera cubeta cuyo límite superior es >= value
+    int low = 0;
+    int high = static_cast<int>(buckets.size());
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (orderValues(buckets[mid].upper, value) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < static_cast<int>(buckets.size())) ? low : -1;
+}
+
+double EquiDepthHistogram::fractionInBucket(int bucket, const std::string& value) const {
+    const std::string& low = (bucket == 0) ? lower : buckets[bucket - 1].upper;
+    const std::string& high = buckets[bucket].upper;
+    double low_number, high_number, number;
+    if (numeric && parseNumber(low, low_number) && parseNumber(high, high_number) &&
+        parseNumber(value, number)) {
+        if (high_number <= low_number) return 0.0;
+        return std::max(0.0, std::min(1.0, (number - low_number) / (high_number - low_number)));
+    }
+    return 0.5;  // Sin interpolación posible para textos
+}
+
+void EquiDepthHistogram::add(const std::string& value) {
+    if (buckets.empty()) return;  // Sin ANALYZE previo
+    
+    double number;
+    if (numeric && !parseNumber(value, number)) {
+        numeric = false;
+    }
+    if (orderValues(value, lower) < 0) {
+        lower = value;
+    }
+    int bucket = findBucket(value);
+    if (bucket < 0) {
+        // Nuevo máximo: ampliar la última cubeta
+        bucket = static_cast<int>(buckets.size()) - 1;
+        buckets[bucket].upper = value;
+    }
+    buckets[bucket].count++;
+    total++;
+}
+
+void EquiDepthHistogram::remove(const std::string& value) {
+    int bucket = findBucket(value);
+    if (bucket >= 0 && buckets[bucket].count > 0) {
+        buckets[bucket].count--;
+        total--;
+    }
+}
+
+bool EquiDepthHistogram::isEmpty() const {
+    return buckets.empty() || total <= 0;
+}
+
+double EquiDepthHistogram::estimateSelectivity(const Comparison& comparison) const {
+    if (isEmpty()) return 0.0;
+    
+    // Prefijo: fracción entre el prefijo y la menor cadena que ya no lo
+    // tiene. En columnas numéricas el histograma no sigue el orden de texto
+    // y la estimación es solo orientativa.
+    if (comparison.op == CompareOp::PREFIX) {
+        std::string upper = comparison.value;
+        while (!upper.empty() && static_cast<unsigned char>(upper.back()) == 0xFF) {
+            upper.pop_back();
+        }
+        double from = estimateSelectivity(Comparison(comparison.attribute, CompareOp::LT, 
+                                                     comparison.value));
+        double to = 1.0;
+        if (!upper.empty()) {
+            upper.back() = static_cast<char>(upper.back() + 1);
+            to = estimateSelectivity(Comparison(comparison.attribute, CompareOp::LT, upper));
+        }
+        return std::max(0.0, std::min(1.0, to - from));
+    }
+    const std::string& value = comparison.value;
+    
+    // Fracción de valores iguales y estrictamente menores que la constante
+    double equal = 0.0;
+    double less = 0.0;
+    if (orderValues(value, lower) >= 0) {
+        int bucket = findBucket(value);
+        if (bucket < 0) {
+            less = 1.0;
+        } else {
+            long long below = 0;
+            for (int i = 0; i < bucket; ++i) {
+                below += buckets[i].count;
+            }
+            const Bucket& current = buckets[bucket];
+            double in_bucket = current.count * fractionInBucket(bucket, value);
+            equal = static_cast<double>(current.count) / std::max(1LL, current.distinct);
+            in_bucket = std::min(in_bucket, current.count - equal);
+            less = (below + std::max(0.0, in_bucket)) / total;
+            equal /= total;
+        }
+    }
+    
+    double selectivity = 0.0;
+    switch (comparison.op) {
+        case CompareOp::EQ: selectivity = equal; break;
+        case CompareOp::NE: selectivity = 1.0 - equal; break;
+        case CompareOp::LT: selectivity = less; break;
+        case CompareOp::LE: selectivity = less + equal; break;
+        case CompareOp::GT: selectivity = 1.0 - less - equal; break;
+        case CompareOp::GE: selectivity = 1.0 - less; break;
+        case CompareOp::PREFIX: break;  // Resuelto arriba
+    }
+    return std::max(0.0, std::min(1.0, selectivity));
+}
+
+const std::vector<EquiDepthHistogram::Bucket>& EquiDepthHistogram::getBuckets() const {
+    return buckets;
+}
+
+size_t EquiDepthHistogram::getMemoryUsage() const {
+    size_t bytes = stringHeapMemory(lower) + buckets.capacity() * sizeof(Bucket);
+    for (const auto& bucket : buckets) {
+        bytes += stringHeapMemory(bucket.upper);
+    }
+    return bytes;
+}
+
+// Los límites de las cubetas de texto pueden ser muy largos: se recortan
+// para que ANALYZE y las estadísticas no inunden la salida
+static std::string shortBound(const std::string& bound) {
+    const size_t max_chars = 20;
+    return (bound.length() > max_chars) ? bound.substr(0, max_chars) + "..." : bound;
+}
+
+void EquiDepthHistogram::print() const {
+    std::cout << "    Histogram (" << buckets.size() << " buckets): [" << shortBound(lower);
+    for (const auto& bucket : buckets) {
+        std::cout << " .. " << shortBound(bucket.upper) << " (" << bucket.count << ")";
+    }
+    std::cout << "]\n";
+}
+
+void EquiDepthHistogram::save(SnapshotWriter& out) const {
+    out.putString(lower);
+    out.putU8(numeric ? 1 : 0);
+    out.putI64(total);
+    out.putU32(static_cast<uint32_t>(buckets.size()));
+    for (const auto& bucket : buckets) {
+        out.putString(bucket.upper);
+        out.putI64(bucket.count);
+        out.putI64(bucket.distinct);
+    }
+}
+
+bool EquiDepthHistogram::load(SnapshotReader& in) {
+    uint32_t count;
+    if (!in.getString(lower) || !in.getBool(numeric) || !in.getI64(total) ||
+        !in.getCount(count, 20)) {
+        return false;
+    }
+    buckets.assign(count, Bucket());
+    for (auto& bucket : buckets) {
+        if (!in.getString(bucket.upper) || !in.getI64(bucket.count) || !in.getI64(bucket.distinct)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==================== COLUMN STATS ====================
+ColumnStats::ColumnStats() : value_count(0), total_width(0) {}
+
+void ColumnStats::add(const std::string& value) {
+    if (value.empty()) return;  // Los valores vacíos cuentan como nulos
+    distinct_sketch.add(value);
+    histogram.add(value);
+    value_count++;
+    total_width += static_cast<long long>(value.length());
+}
+
+void ColumnStats::remove(const std::string& value) {
+    // El sketch de distintos no admite borrados: solo se ajustan los contadores
+    if (value.empty() || value_count == 0) return;
+    histogram.remove(value);
+    value_count--;
+    total_width -= static_cast<long long>(value.length());
+}
+
+void ColumnStats::rebuild(std::vector<std::string> values, int histogram_buckets) {
+    values.erase(std::remove(values.begin(), values.end(), std::string()), values.end());
+    
+    distinct_sketch.clear();
+    value_count = 0;
+    total_width = 0;
+    for (const auto& value : values) {
+        distinct_sketch.add(value);
+        value_count++;
+        total_width += static_cast<long long>(value.length());
+    }
+    
+    std::sort(values.begin(), values.end(), 
+              [](const std::string& a, const std::string& b) { return orderValues(a, b) < 0; });
+    histogram.build(values, histogram_buckets);
+}
+
+double ColumnStats::getDistinctCount() const {
+    // El sketch nunca puede superar el número de valores observados
+    return std::min(distinct_sketch.estimate(), static_cast<double>(value_count));
+}
+
+double ColumnStats::getNullFraction(long long row_count) const {
+    if (row_count <= 0) return 0.0;
+    return std::max(0.0, 1.0 - static_cast<double>(value_count) / row_count);
+}
+
+double ColumnStats::getAverageWidth() const {
+    return (value_count > 0) ? static_cast<double>(total_width) / value_count : 0.0;
+}
+
+long long ColumnStats::getValueCount() const {
+    return value_count;
+}
+
+bool ColumnStats::hasHistogram() const {
+    return !histogram.isEmpty();
+}
+
+size_t ColumnStats::getMemoryUsage() const {
+    return sizeof(ColumnStats) + distinct_sketch.getMemoryUsage() + histogram.getMemoryUsage();
+}
+
+double ColumnStats::estimateSelectivity(const Comparison& comparison, long long row_count) const {
+    if (row_count <= 0) return 0.0;
+    double non_null = 1.0 - getNullFraction(row_count);
+    
+    if (hasHistogram()) {
+        return non_null * histogram.estimateSelectivity(comparison);
+    }
+    
+    // Sin histograma: distribución uniforme sobre los valores distintos
+    double distinct = std::max(1.0, getDistinctCount());
+    switch (comparison.op) {
+        case CompareOp::EQ: return non_null / distinct;
+        case CompareOp::NE: return non_null * (1.0 - 1.0 / distinct);
+        default: return non_null / 3.0;
+    }
+}
+
+void ColumnStats::print(const std::string& column, long long row_count) const {
+    std::cout << "  " << column << ": ~" << static_cast<long long>(std::round(getDistinctCount())) 
+              << " distinct, " << getNullFraction(row_count) * 100 << "% null, avg width "
+              << getAverageWidth() << " bytes\n";
+    if (hasHistogram()) {
+        histogram.print();
+    }
+}
+
+void ColumnStats::save(SnapshotWriter& out) const {
+    distinct_sketch.save(out);
+    histogram.save(out);
+    out.putI64(value_count);
+    out.putI64(total_width);
+}
+
+bool ColumnStats::load(SnapshotReader& in) {
+    return distinct_sketch.load(in) && histogram.load(in) &&
+           in.getI64(value_count) && in.getI64(total_width);
+}
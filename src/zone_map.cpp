@@ -0,0 +1,174 @@
+#include "zone_map.h"
+#include <cmath>
+
+// ==================== COLUMN ZONE ====================
+ColumnZone::ColumnZone() 
+    : all_numeric(true), min_number(0), max_number(0), value_count(0) {}
+
+void ColumnZone::add(const std::string& value) {
+    if (value_count == 0 || value < min_text) min_text = value;
+    if (value_count == 0 || value > max_text) max_text = value;
+    
+    // parseNumber solo acepta números finitos: un "nan" deja el rango
+    // numérico sin usar en vez de fijar min y max a NaN para siempre
+    double number;
+    if (all_numeric && parseNumber(value, number)) {
+        if (value_count == 0 || number < min_number) min_number = number;
+        if (value_count == 0 || number > max_number) max_number = number;
+    } else {
+        all_numeric = false;
+    }
+    value_count++;
+}
+
+// Comprobar si el rango [low, high] puede contener algún valor que cumpla 'op'
+template <typename T>
+static bool rangeMayMatch(CompareOp op, const T& low, const T& high, const T& constant) {
+    switch (op) {
+        case CompareOp::EQ: return !(constant < low) && !(high < constant);
+        case CompareOp::NE: return !(low == constant && high == constant);
+        case CompareOp::LT: return low < constant;
+        case CompareOp::LE: return !(constant < low);
+        case CompareOp::GT: return constant < high;
+        case CompareOp::GE: return !(high < constant);
+        case CompareOp::PREFIX: return true;  // Se resuelve sobre el rango de texto
+    }
+    return true;
+}
+
+bool ColumnZone::mayMatch(const Comparison& comparison) const {
+    if (value_count == 0) {
+        return false;  // Solo nulos: ninguna comparación puede cumplirse
+    }
+    
+    // Los valores que empiezan por el prefijo forman un intervalo del orden
+    // de texto: alguno cae en [min, max] si max no queda antes del prefijo
+    // y min no queda después de todos ellos
+    if (comparison.op == CompareOp::PREFIX) {
+        const std::string& prefix = comparison.value;
+        return !(max_text < prefix) && min_text.compare(0, prefix.length(), prefix) <= 0;
+    }
+    
+    // Comparison compara numéricamente solo si constante y valor son números;
+    // con columnas mixtas el orden no es coherente y no se puede descartar
+    if (comparison.is_numeric) {
+        if (!all_numeric) return true;
+        return rangeMayMatch(comparison.op, min_number, max_number, comparison.numeric_value);
+    }
+    return rangeMayMatch(comparison.op, min_text, max_text, comparison.value);
+}
+
+void ColumnZone::save(SnapshotWriter& out) const {
+    out.putString(min_text);
+    out.putString(max_text);
+    out.putU8(all_numeric ? 1 : 0);
+    out.putDouble(min_number);
+    out.putDouble(max_number);
+    out.putI32(value_count);
+}
+
+bool ColumnZone::load(SnapshotReader& in) {
+    if (!(in.getString(min_text) && in.getString(max_text) && in.getBool(all_numeric) &&
+          in.getDouble(min_number) && in.getDouble(max_number) && in.getI32(value_count))) {
+        return false;
+    }
+    // Un rango no finito (instantáneas anteriores) no sirve para descartar
+    if (!std::isfinite(min_number) || !std::isfinite(max_number)) {
+        all_numeric = false;
+    }
+    return true;
+}
+
+// ==================== ZONE MAP ====================
+ZoneMap::ZoneMap() : row_count(0) {}
+
+void ZoneMap::add(const Record& record) {
+    if (record.is_deleted) return;
+    row_count++;
+    for (const auto& pair : record.data) {
+        columns[pair.first].add(pair.second);
+    }
+}
+
+void ZoneMap::clear() {
+    columns.clear();
+    row_count = 0;
+}
+
+void ZoneMap::rebuild(const std::vector<Record>& records) {
+    clear();
+    for (const auto& record : records) {
+        add(record);
+    }
+}
+
+bool ZoneMap::mayMatchNode(const Predicate::Node& node) const {
+    switch (node.kind) {
+        case Predicate::Kind::TRUE_CONST:
+            return row_count > 0;
+        case Predicate::Kind::COMPARISON: {
+            auto it = columns.find(node.comparison.attribute);
+            return it != columns.end() && it->second.mayMatch(node.comparison);
+        }
+        case Predicate::Kind::AND:
+            for (const auto& child : node.children) {
+                if (!mayMatchNode(child)) return false;
+            }
+            return true;
+        case Predicate::Kind::OR:
+            for (const auto& child : node.children) {
+                if (mayMatchNode(child)) return true;
+            }
+            return false;
+    }
+    return true;
+}
+
+bool ZoneMap::mayMatch(const Predicate& predicate) const {
+    if (row_count == 0) return false;
+    return mayMatchNode(predicate.getRoot());
+}
+
+const ColumnZone* ZoneMap::getColumn(const std::string& attribute) const {
+    auto it = columns.find(attribute);
+    return (it != columns.end()) ? &it->second : nullptr;
+}
+
+int ZoneMap::getNullCount(const std::string& attribute) const {
+    const ColumnZone* zone = getColumn(attribute);
+    return row_count - (zone != nullptr ? zone->value_count : 0);
+}
+
+int ZoneMap::getRowCount() const {
+    return row_count;
+}
+
+size_t ZoneMap::getMemoryUsage() const {
+    const size_t node_size = 4 * sizeof(void*) + sizeof(std::pair<const std::string, ColumnZone>);
+    size_t bytes = sizeof(ZoneMap) + columns.size() * node_size;
+    for (const auto& pair : columns) {
+        bytes += stringHeapMemory(pair.first) + stringHeapMemory(pair.second.min_text) +
+                 stringHeapMemory(pair.second.max_text);
+    }
+    return bytes;
+}
+
+void ZoneMap::save(SnapshotWriter& out) const {
+    out.putI32(row_count);
+    out.putU32(static_cast<uint32_t>(columns.size()));
+    for (const auto& pair : columns) {
+        out.putString(pair.first);
+        pair.second.save(out);
+    }
+}
+
+bool ZoneMap::load(SnapshotReader& in) {
+    clear();
+    uint32_t count;
+    if (!in.getI32(row_count) || !in.getCount(count, 33)) return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string column;
+        if (!in.getString(column) || !columns[column].load(in)) return false;
+    }
+    return true;
+}
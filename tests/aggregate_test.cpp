@@ -0,0 +1,52 @@
+#include "sgbd.h"
+#include <iostream>
+
+// Prueba de regresión: la agregación trata los valores igual que el WHERE.
+// "7" y "7.0" forman un solo grupo y "12abc" no es un número que sumar.
+
+int main() {
+    SGBD system(2, 2, 10, 8, 512, 32 * 1024, 2048, 0.9);
+    system.setVerbose(false);
+    system.createTable("sales", {"g", "v"});
+    
+    const std::vector<std::pair<std::string, std::string>> rows = {
+        {"7", "10"}, {"7.0", "12abc"}, {"007", "5"}, {"8", "1"}, {"8.00", "nan"}, {"x", "3"}
+    };
+    std::vector<Record> batch;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        batch.emplace_back(std::map<std::string, std::string>{
+            {"g", rows[i].first}, {"v", rows[i].second}}, 100 + static_cast<int>(i));
+    }
+    system.addRecords(batch, "sales");
+    
+    // Grupo -> (COUNT(*), SUM(v), COUNT(v))
+    struct Expected { long long count; double sum; long long values; };
+    const std::map<std::string, Expected> expected = {
+        {"7", {3, 15, 3}}, {"8", {2, 1, 2}}, {"x", {1, 3, 1}}
+    };
+    
+    std::vector<AggregateRow> result = system.aggregate({"g"}, {"COUNT(*)", "SUM(v)", "COUNT(v)"}, 
+                                                        "", "sales");
+    int failures = 0;
+    if (result.size() != expected.size()) {
+        std::cerr << "FAIL: " << result.size() << " grupos, se esperaban " 
+                  << expected.size() << "\n";
+        failures++;
+    }
+    for (const auto& row : result) {
+        auto it = expected.find(row.group_values.empty() ? "" : row.group_values[0]);
+        if (it == expected.end() || row.values.size() != 3 ||
+            row.values[0] != it->second.count || row.values[1] != it->second.sum ||
+            row.values[2] != it->second.values) {
+            std::cerr << "FAIL: grupo inesperado '" 
+                      << (row.group_values.empty() ? "" : row.group_values[0]) << "'\n";
+            failures++;
+        }
+    }
+    
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "aggregate_test: " << result.size() << " grupos OK\n";
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "sgbd.h"
+#include <iostream>
+
+// Prueba de regresión: con el buffer lleno de bloques recién insertados,
+// la fracción de desalojos que escriben la víctima en primer plano debe
+// bajar cuando el escritor en segundo plano está activo.
+
+struct Phase {
+    long long evictions;
+    long long dirty_evictions;
+
+    double dirtyFraction() const {
+        return evictions > 0 ? static_cast<double>(dirty_evictions) / evictions : 0.0;
+    }
+};
+
+// Inserciones en lotes pequeños, como la fase de métricas del ejemplo; solo
+// se cuentan los desalojos posteriores al llenado del buffer. En vez de
+// pausas, tras cada lote se espera a que el escritor complete una ronda, de
+// modo que el resultado no depende de la carga de la máquina.
+static Phase runWorkload(bool with_writer) {
+    SGBD system(4, 2, 40, 16, 512, 128 * 1024, 2048, 0.9);
+    system.setVerbose(false);
+    system.createTable("metrics", {"sensor", "reading"});
+
+    auto insertBatch = [&](int round) {
+        std::vector<Record> batch;
+        for (int i = 0; i < 40; ++i) {
+            std::map<std::string, std::string> data = {
+                {"sensor", "s" + std::to_string(i % 8)},
+                {"reading", std::to_string((round * 40 + i) * 37 % 1000)}
+            };
+            batch.emplace_back(data, system.allocateRecordId());
+        }
+        system.addRecords(batch, "metrics");
+    };
+
+    int round = 0;
+    for (; round < 30; ++round) {
+        insertBatch(round);
+    }
+
+    Phase before;
+    system.getEvictionStats(before.evictions, before.dirty_evictions);
+    if (with_writer) {
+        // Sin límite de E/S ni checkpoints; el periodo es tan largo que
+        // las rondas solo llegan por los avisos y por runBackgroundWriterRound()
+        system.startBackgroundWriter(WriterConfig(0, 60 * 1000, 16, 0));
+    }
+    for (int end = round + 30; round < end; ++round) {
+        insertBatch(round);
+        if (with_writer && !system.runBackgroundWriterRound()) {
+            std::cerr << "FAIL: el escritor no completó la ronda\n";
+            return Phase{0, 0};
+        }
+    }
+    system.stopBackgroundWriter();
+
+    Phase after;
+    system.getEvictionStats(after.evictions, after.dirty_evictions);
+    return {after.evictions - before.evictions, after.dirty_evictions - before.dirty_evictions};
+}
+
+int main() {
+    Phase without_writer = runWorkload(false);
+    Phase with_writer = runWorkload(true);
+
+    std::cout << "background_writer_test: sin escritor " << without_writer.dirty_evictions
+              << "/" << without_writer.evictions << " desalojos escribieron la víctima, con escritor "
+              << with_writer.dirty_evictions << "/" << with_writer.evictions << "\n";
+
+    if (without_writer.evictions == 0 || with_writer.evictions == 0) {
+        std::cerr << "FAIL: la carga no llegó a desalojar bloques\n";
+        return 1;
+    }
+    if (without_writer.dirtyFraction() == 0.0) {
+        std::cerr << "FAIL: sin escritor ningún desalojo escribió la víctima\n";
+        return 1;
+    }
+    if (with_writer.dirtyFraction() >= without_writer.dirtyFraction()) {
+        std::cerr << "FAIL: el escritor no redujo la fracción de desalojos con escritura\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "compression.h"
+#include <iostream>
+
+// Prueba de regresión: un bloque corrupto con un recuento de registros o un
+// tamaño descomprimido enormes debe rechazarse sin intentar reservarlos.
+
+static std::string varint(uint64_t value) {
+    std::string out;
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+    return out;
+}
+
+static std::string header(uint8_t flags) {
+    std::string out = "BK";
+    out += static_cast<char>(BlockCodec::FORMAT_VERSION);
+    out += static_cast<char>(flags);
+    return out;
+}
+
+int main() {
+    int failures = 0;
+    std::vector<Record> records;
+    
+    // Ida y vuelta de un bloque válido
+    std::vector<Record> original;
+    for (int i = 0; i < 50; ++i) {
+        original.emplace_back(std::map<std::string, std::string>{
+            {"k", std::to_string(i % 5)}, {"name", "row" + std::to_string(i)}}, 10 + i);
+    }
+    if (!BlockCodec::decode(BlockCodec::encode(original), records) || records.size() != original.size()) {
+        std::cerr << "FAIL: un bloque válido no se decodifica\n";
+        failures++;
+    }
+    
+    const std::vector<std::pair<std::string, std::string>> corrupt = {
+        {"recuento de registros", header(0) + varint(1ULL << 40) + std::string(16, '\0')},
+        {"tamaño descomprimido", header(BlockCodec::FLAG_LZ) + varint(1ULL << 40) + std::string(16, '\0')},
+        {"tamaño de diccionario", header(0) + varint(1) + varint(0) + std::string(1, '\0') + 
+                                  varint(1) + varint(1) + "k" + std::string(1, '\x01') + 
+                                  std::string(1, '\x01') + varint(1ULL << 40)}
+    };
+    for (const auto& test : corrupt) {
+        if (BlockCodec::decode(test.second, records)) {
+            std::cerr << "FAIL: se aceptó un " << test.first << " corrupto\n";
+            failures++;
+        }
+    }
+    
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "codec_test: " << corrupt.size() + 1 << " bloques OK\n";
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "sgbd.h"
+#include <iostream>
+#include <set>
+
+// Prueba de regresión: una consulta de igualdad debe devolver los mismos
+// registros por recorrido completo que a través del índice hash, aunque la
+// constante o los valores almacenados no estén escritos en forma canónica.
+
+static std::set<int> queryIds(SGBD& system, const std::string& expression) {
+    std::set<int> ids;
+    for (const Record& record : system.query(expression, "numbers")) {
+        ids.insert(record.record_id);
+    }
+    return ids;
+}
+
+static std::set<int> scanIds(SGBD& system, const std::string& expression) {
+    std::set<int> ids;
+    Predicate predicate;
+    std::string error;
+    Predicate::parse(expression, predicate, error);
+    system.scan(predicate, [&](const RecordView& view) {
+        ids.insert(view.getId());
+        return true;
+    }, "numbers");
+    return ids;
+}
+
+int main() {
+    SGBD system(2, 2, 10, 8, 512, 32 * 1024, 2048, 0.9);
+    system.createTable("numbers", {"k", "label"});
+    
+    const std::vector<std::string> values = {
+        "7", "7.0", "007", "7.000", "8", "-0", "0", "0.0", "1e1", "10", "abc", "7x",
+        "nan", "inf", "-inf", " 7", "0x7", "+7"
+    };
+    std::vector<Record> batch;
+    for (size_t i = 0; i < values.size() * 4; ++i) {
+        std::map<std::string, std::string> data = {
+            {"k", values[i % values.size()]},
+            {"label", "row" + std::to_string(i)}
+        };
+        batch.emplace_back(data, 1000 + static_cast<int>(i));
+    }
+    system.addRecords(batch, "numbers");
+    
+    const std::vector<std::string> expressions = {
+        "k = 7", "k = 7.0", "k = 07", "k = '7.000'", "k = 0", "k = -0.0",
+        "k = 10", "k = 1e1", "k = 10.0", "k = 'abc'", "k = '7x'", "k = 9",
+        "k = nan", "k = 'NaN'", "k = inf", "k = -inf", "k = 1e999", "k = '0x7'", "k = ' 7'"
+    };
+    
+    std::vector<std::set<int>> before;
+    for (const auto& expression : expressions) {
+        before.push_back(queryIds(system, expression));
+    }
+    
+    if (!system.createIndex("k")) {
+        std::cerr << "FAIL: no se pudo crear el índice sobre k\n";
+        return 1;
+    }
+    
+    int failures = 0;
+    for (size_t i = 0; i < expressions.size(); ++i) {
+        std::set<int> indexed = queryIds(system, expressions[i]);
+        std::set<int> scanned = scanIds(system, expressions[i]);
+        if (indexed != before[i] || scanned != before[i]) {
+            std::cerr << "FAIL: " << expressions[i] << " -> recorrido "
+                      << before[i].size() << ", índice " << indexed.size()
+                      << ", scan " << scanned.size() << "\n";
+            failures++;
+        }
+    }
+    
+    // "nan" e "inf" son texto: solo coinciden consigo mismos y un número no
+    // los alcanza (cada valor aparece 4 veces)
+    const std::vector<std::pair<std::string, size_t>> expected = {
+        {"k = nan", 4}, {"k = inf", 4}, {"k = 7", 20}, {"k = 5", 0}, {"k = 1e999", 0}
+    };
+    for (const auto& check : expected) {
+        size_t found = queryIds(system, check.first).size();
+        if (found != check.second) {
+            std::cerr << "FAIL: " << check.first << " -> " << found 
+                      << " registros, se esperaban " << check.second << "\n";
+            failures++;
+        }
+    }
+    
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "index_consistency_test: " << expressions.size() << " consultas OK\n";
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "sgbd.h"
+#include <iostream>
+#include <sstream>
+
+// Prueba de regresión del hash join:
+// - Las claves se comparan como en el WHERE: "7" une con "7.0" y "007",
+//   tanto en memoria como en la variante grace.
+// - El presupuesto se aplica a lo que ocupan en memoria las copias de la
+//   tabla hash, no al tamaño codificado de los bloques.
+
+static size_t joinRows(SGBD& system, long long budget, std::string& plan) {
+    // Los mensajes de la operación indican el plan elegido
+    std::ostringstream captured;
+    std::streambuf* previous = std::cout.rdbuf(captured.rdbuf());
+    system.setVerbose(true);
+    size_t rows = system.hashJoin("left", "k", "right", "k", budget).size();
+    system.setVerbose(false);
+    std::cout.rdbuf(previous);
+    plan = captured.str().find("grace hash join") != std::string::npos ? "grace" : "memory";
+    return rows;
+}
+
+int main() {
+    SGBD system(4, 2, 40, 16, 512, 256 * 1024, 2048, 0.9);
+    system.setVerbose(false);
+    system.createTable("left", {"k"});
+    system.createTable("right", {"k", "name"});
+    
+    // Lado izquierdo: 200 registros con claves cortas, 20 de ellas numéricas
+    // escritas de otra forma que en el lado derecho
+    std::vector<Record> left;
+    for (int i = 0; i < 200; ++i) {
+        std::string key = (i < 20) ? std::to_string(i) + ".0" : "t" + std::to_string(i);
+        left.emplace_back(std::map<std::string, std::string>{{"k", key}}, 1000 + i);
+    }
+    system.addRecords(left, "left");
+    
+    std::vector<Record> right;
+    for (int i = 0; i < 400; ++i) {
+        std::string key = (i < 20) ? "00" + std::to_string(i) : "u" + std::to_string(i);
+        right.emplace_back(std::map<std::string, std::string>{
+            {"k", key}, {"name", "row" + std::to_string(i)}}, 5000 + i);
+    }
+    system.addRecords(right, "right");
+    
+    int failures = 0;
+    // Sin límite práctico: en memoria. El presupuesto de 8 KB está por encima
+    // del tamaño codificado del lado izquierdo pero por debajo de sus copias.
+    // Con 64 bytes, grace con muchas particiones.
+    const std::vector<std::pair<long long, std::string>> cases = {
+        {1024 * 1024, "memory"}, {8 * 1024, "grace"}, {64, "grace"}
+    };
+    for (const auto& test : cases) {
+        std::string plan;
+        size_t rows = joinRows(system, test.first, plan);
+        if (rows != 20 || plan != test.second) {
+            std::cerr << "FAIL: presupuesto " << test.first << " -> " << rows 
+                      << " filas con plan " << plan << ", se esperaban 20 con plan " 
+                      << test.second << "\n";
+            failures++;
+        }
+    }
+    
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "join_test: " << cases.size() << " joins OK\n";
+    return 0;
+}
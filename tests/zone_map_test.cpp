@@ -0,0 +1,57 @@
+#include "sgbd.h"
+#include <iostream>
+
+// Prueba de regresión: un valor no numérico como "nan" al principio de un
+// bloque no debe fijar el rango numérico del mapa de zonas y hacer que se
+// descarten bloques con registros que cumplen la condición.
+
+int main() {
+    SGBD system(2, 2, 10, 8, 512, 32 * 1024, 2048, 0.9);
+    system.setVerbose(false);
+    system.createTable("readings", {"k"});
+    
+    std::vector<Record> batch;
+    const std::vector<std::string> values = {"nan", "5", "20", "7", "inf"};
+    for (size_t i = 0; i < values.size(); ++i) {
+        batch.emplace_back(std::map<std::string, std::string>{{"k", values[i]}},
+                           100 + static_cast<int>(i));
+    }
+    system.addRecords(batch, "readings");
+    
+    // Lo esperado se obtiene comparando cada valor con compareValues, sin
+    // pasar por el mapa de zonas ("nan" e "inf" se comparan como texto)
+    const std::vector<std::pair<CompareOp, std::string>> checks = {
+        {CompareOp::GT, "10"}, {CompareOp::LT, "6"}, {CompareOp::GE, "5"},
+        {CompareOp::EQ, "nan"}, {CompareOp::EQ, "20"}, {CompareOp::LE, "7"}
+    };
+    int failures = 0;
+    for (const auto& check : checks) {
+        size_t expected = 0;
+        for (const auto& value : values) {
+            int order = compareValues(value, check.second);
+            bool match = false;
+            switch (check.first) {
+                case CompareOp::GT: match = order > 0; break;
+                case CompareOp::LT: match = order < 0; break;
+                case CompareOp::GE: match = order >= 0; break;
+                case CompareOp::LE: match = order <= 0; break;
+                default: match = order == 0; break;
+            }
+            if (match) expected++;
+        }
+        
+        std::string expression = "k " + compareOpToString(check.first) + " " + check.second;
+        size_t found = system.query(expression, "readings").size();
+        if (found != expected) {
+            std::cerr << "FAIL: " << expression << " -> " << found 
+                      << " registros, se esperaban " << expected << "\n";
+            failures++;
+        }
+    }
+    
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "zone_map_test: " << checks.size() << " consultas OK\n";
+    return 0;
+}